@@ -70,16 +70,27 @@
 #define configTIMER_TASK_STACK_DEPTH               ( configMINIMAL_STACK_SIZE * 2 )
 
 // Se extiende el valor máximo de prioridad y se deja un margen para otras tareas del sistema como la tarea idle.
+// Si hay más tareas activas que niveles, el LLF agrupa las holguras en bandas (ver planificador.c).
 #define configMAX_PRIORITIES                       ( 15 )
 
-// Se define para registrar la última tarea ejecutada - Fuente: https://www.freertos.org/Documentation/02-Kernel/02-Kernel-features/09-RTOS-trace-feature
-#define traceTASK_SWITCHED_IN() actualizarTareaEjecutada(pxCurrentTCB)
+// Kernel SMP (FreeRTOS V11 o posterior) con make NUCLEOS=<n>. Con varias prioridades en
+// ejecución a la vez el LLF global ejecuta las n tareas de menor holgura, y la afinidad
+// permite fijar cada tarea a un núcleo en el LLF particionado (ver planificador.c).
+#ifdef NUCLEOS
+    #define configNUMBER_OF_CORES                  NUCLEOS
+    #define configRUN_MULTIPLE_PRIORITIES          1
+    #define configUSE_CORE_AFFINITY                1
+#endif
 
 /* Run time stats gathering configuration options. */
 unsigned long ulGetRunTimeCounterValue( void ); /* Prototype of function that returns run time counter. */
 void vConfigureTimerForRunTimeStats( void );    /* Prototype of function that initialises the run time counter. */
 #define configGENERATE_RUN_TIME_STATS             1
 
+// El contador de tiempo de ejecución cuenta microsegundos (ver main.c). La variante
+// ALT tiene preferencia sobre el contador por defecto del port POSIX, basado en times().
+#define portALT_GET_RUN_TIME_COUNTER_VALUE( ulCountValue )    ( ulCountValue ) = ulGetRunTimeCounterValue()
+
 /* Co-routine related configuration options. */
 #define configUSE_CO_ROUTINES                     0
 #define configMAX_CO_ROUTINE_PRIORITIES           ( 2 )
@@ -160,6 +171,19 @@ extern void vAssertCalled( const char * const pcFileName,
     #include "trcRecorder.h"
 #endif /* if ( projCOVERAGE_TEST == 1 ) */
 
+// Se define para registrar la tarea que sale de la CPU - Fuente: https://www.freertos.org/Documentation/02-Kernel/02-Kernel-features/09-RTOS-trace-feature
+// El planificador LLF acumula en él el tiempo de CPU consumido por cada tarea y
+// cuenta los cambios de contexto. Solo usa traceTASK_SWITCHED_OUT, de modo que
+// traceTASK_SWITCHED_IN sigue siendo del grabador de trazas (trcRecorder.h) y la
+// traza conserva los cambios de tarea. Si el grabador también definiera este
+// hook no se podría encadenar con el del LLF, así que se detiene la compilación.
+// La etiqueta de cada tarea (configUSE_APPLICATION_TASK_TAG) apunta a sus datos de planificación.
+#ifdef traceTASK_SWITCHED_OUT
+    #error El grabador de trazas ya define traceTASK_SWITCHED_OUT, que necesita el planificador LLF.
+#endif
+void registrarSalidaTarea( void * pxCurrentTCB, void * etiqueta );
+#define traceTASK_SWITCHED_OUT() registrarSalidaTarea( pxCurrentTCB, ( void * ) pxCurrentTCB->pxTaskTag )
+
 /* networking definitions */
 #define configMAC_ISR_SIMULATOR_PRIORITY    ( configMAX_PRIORITIES - 1 )
 
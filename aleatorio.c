@@ -0,0 +1,304 @@
+/*
+ * FreeRTOS V202112.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+ /***************************************************************************************
+ * Módulo:              Generador de números aleatorios reproducible por tarea.         *
+ *                                                                                      *
+ *                      Cada tarea siembra su propio generador xoshiro256++ con la      *
+ *                      semilla del programa y un flujo (por ejemplo, el trabajo),      *
+ *                      de modo que las mismas semillas dan las mismas muestras sin     *
+ *                      depender del orden de ejecución de las tareas. Los valores      *
+ *                      normales se obtienen con el método ziggurat.                    *
+ *                                                                                      *
+ * Autor:               Juan Misael Sánchez Pacheco                                     *
+ * Fecha:               17 de octubre de 2026                                           *
+ * Versión:             1.0                                                             *
+ * Observaciones:       Fuentes de los algoritmos:                                      *
+ *                          - https://prng.di.unimi.it/ (xoshiro256++ y splitmix64)     *
+ *                          - G. Marsaglia y W. W. Tsang, "The Ziggurat Method for      *
+ *                            Generating Random Variables", 2000.                       *
+ *                          - J. A. Doornik, "An Improved Ziggurat Method to Generate   *
+ *                            Normal Random Samples", 2005.                             *
+ ****************************************************************************************/
+
+
+
+
+/*-----------------------------------------------------------*/
+
+
+
+
+/* BIBLIOTECAS */
+
+/* Bibliotecas utilizadas */
+#include <math.h> // Es necesario incluir -lm al compilar.
+#include <stdbool.h>
+
+/* Local includes. */
+#include "aleatorio.h"
+
+
+
+
+/*-----------------------------------------------------------*/
+
+
+
+
+/* CONSTANTES. */
+
+// Capas del ziggurat. El índice de la capa sale de los 8 bits bajos de cada valor.
+#define CAPAS_ZIGGURAT 256
+
+// Inicio de la cola de la normal (R) y área de cada capa (V) para 256 capas.
+#define COLA_ZIGGURAT 3.6541528853610088
+#define AREA_ZIGGURAT 0.00492867323399
+
+// Pasa los 53 bits altos de un valor aleatorio a un double en [0, 1).
+#define ESCALA_53_BITS ( 1.0 / 9007199254740992.0 )
+
+
+
+
+/*-----------------------------------------------------------*/
+
+
+
+
+/* VARIABLES Y DATOS. */
+
+// Tablas del ziggurat: x[i] es el borde derecho de la capa i y f[i] la densidad
+// (sin normalizar) en ese punto. x[0] es la anchura equivalente de la capa base.
+static double x_ziggurat[CAPAS_ZIGGURAT + 1];
+static double f_ziggurat[CAPAS_ZIGGURAT + 1];
+
+
+
+
+/*-----------------------------------------------------------*/
+
+
+
+
+// PROTOTIPOS DE FUNCIONES.
+
+static double generarColaNormal(GeneradorAleatorio *);
+static uint64_t mezclarSplitMix64(uint64_t *);
+
+
+
+
+/*-----------------------------------------------------------*/
+
+
+
+
+/*
+ * Función:         Siembra un generador a partir de una semilla y un
+ *                  flujo, de forma que cada par da una secuencia
+ *                  distinta y siempre la misma.
+ *
+ * Autor:           Juan Misael Sánchez Pacheco
+ * Fecha:           17 de octubre de 2026
+ * Versión:         1.0
+ * Observaciones:   El estado se expande con splitmix64, que nunca lo
+ *                  deja a cero.
+ */
+void sembrarAleatorio(GeneradorAleatorio *generador, uint64_t semilla, uint64_t flujo)
+{
+    uint64_t mezcla = semilla;
+
+    // El flujo se mezcla antes de combinarlo para que flujos consecutivos no
+    // den estados parecidos.
+    uint64_t mezcla_flujo = flujo;
+    mezcla ^= mezclarSplitMix64(&mezcla_flujo);
+
+    for (int i = 0; i < 4; i++) generador->estado[i] = mezclarSplitMix64(&mezcla);
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:     Devuelve el siguiente valor de 64 bits de xoshiro256++.
+ *
+ * Autor:       Juan Misael Sánchez Pacheco
+ * Fecha:       17 de octubre de 2026
+ * Versión:     1.0
+ */
+uint64_t generarAleatorio(GeneradorAleatorio *generador)
+{
+    uint64_t *s = generador->estado;
+    uint64_t suma = s[0] + s[3];
+    uint64_t resultado = ((suma << 23) | (suma >> 41)) + s[0];
+    uint64_t t = s[1] << 17;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = (s[3] << 45) | (s[3] >> 19);
+
+    return resultado;
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:     Devuelve un valor uniforme en [0, 1).
+ *
+ * Autor:       Juan Misael Sánchez Pacheco
+ * Fecha:       17 de octubre de 2026
+ * Versión:     1.0
+ */
+double generarUniforme(GeneradorAleatorio *generador)
+{
+    return (double)(generarAleatorio(generador) >> 11) * ESCALA_53_BITS;
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:         Devuelve un valor de una normal de media cero y
+ *                  desviación unitaria con el método ziggurat.
+ *
+ * Autor:           Juan Misael Sánchez Pacheco
+ * Fecha:           17 de octubre de 2026
+ * Versión:         1.0
+ * Observaciones:   Con 256 capas, alrededor del 99% de los valores se
+ *                  aceptan con un producto y una comparación; solo el
+ *                  resto evalúa la exponencial o la cola. Las tablas
+ *                  deben estar calculadas (iniciarAleatorio).
+ */
+double generarNormal(GeneradorAleatorio *generador)
+{
+    while (true)
+    {
+        // Un solo valor da la capa (8 bits bajos) y la posición con signo (53 bits altos).
+        uint64_t aleatorio = generarAleatorio(generador);
+        int capa = (int)(aleatorio & (CAPAS_ZIGGURAT - 1));
+        double u = 2.0 * (double)(aleatorio >> 11) * ESCALA_53_BITS - 1.0;
+        double x = u * x_ziggurat[capa];
+
+        // Dentro del rectángulo que la capa comparte con la siguiente: siempre bajo la curva.
+        if (fabs(x) < x_ziggurat[capa + 1]) return x;
+
+        // Fuera de la capa base: la cola de la distribución.
+        if (capa == 0) return u < 0.0 ? -generarColaNormal(generador) : generarColaNormal(generador);
+
+        // Cuña entre el rectángulo y la curva: se acepta si el punto queda bajo la densidad.
+        double y = f_ziggurat[capa] + generarUniforme(generador) * (f_ziggurat[capa + 1] - f_ziggurat[capa]);
+        if (y < exp(-0.5 * x * x)) return x;
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:     Rellena un array con valores de una normal de la
+ *              media y desviación indicadas.
+ *
+ * Autor:       Juan Misael Sánchez Pacheco
+ * Fecha:       17 de octubre de 2026
+ * Versión:     1.0
+ */
+void generarNormales(GeneradorAleatorio *generador, double *valores, int total, double media, double desviacion)
+{
+    for (int i = 0; i < total; i++) valores[i] = media + generarNormal(generador) * desviacion;
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:         Calcula los bordes de las capas del ziggurat y la
+ *                  densidad en cada uno.
+ *
+ * Autor:           Juan Misael Sánchez Pacheco
+ * Fecha:           17 de octubre de 2026
+ * Versión:         1.1
+ * Observaciones:   Se llama una vez al arrancar, antes de iniciar el
+ *                  planificador, así que las tareas solo leen las tablas.
+ *                  Todas las capas tienen el área AREA_ZIGGURAT. La base
+ *                  incluye la cola, por eso su anchura equivalente es
+ *                  V / f(R), mayor que R.
+ */
+void iniciarAleatorio(void)
+{
+    double f_cola = exp(-0.5 * COLA_ZIGGURAT * COLA_ZIGGURAT);
+
+    x_ziggurat[0] = AREA_ZIGGURAT / f_cola;
+    x_ziggurat[1] = COLA_ZIGGURAT;
+    for (int i = 1; i < CAPAS_ZIGGURAT - 1; i++)
+        x_ziggurat[i + 1] = sqrt(-2.0 * log(AREA_ZIGGURAT / x_ziggurat[i] + exp(-0.5 * x_ziggurat[i] * x_ziggurat[i])));
+    x_ziggurat[CAPAS_ZIGGURAT] = 0.0;
+
+    for (int i = 0; i <= CAPAS_ZIGGURAT; i++) f_ziggurat[i] = exp(-0.5 * x_ziggurat[i] * x_ziggurat[i]);
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:     Devuelve un valor de la cola de la normal, mayor que
+ *              COLA_ZIGGURAT, por el método de Marsaglia.
+ *
+ * Autor:       Juan Misael Sánchez Pacheco
+ * Fecha:       17 de octubre de 2026
+ * Versión:     1.0
+ */
+static double generarColaNormal(GeneradorAleatorio *generador)
+{
+    double x, y;
+
+    // 1 - uniforme está en (0, 1], así que el logaritmo es finito.
+    do
+    {
+        x = -log(1.0 - generarUniforme(generador)) / COLA_ZIGGURAT;
+        y = -log(1.0 - generarUniforme(generador));
+    }
+    while (y + y < x * x);
+
+    return COLA_ZIGGURAT + x;
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:     Avanza un estado splitmix64 y devuelve su valor
+ *              mezclado. Solo se usa para sembrar.
+ *
+ * Autor:       Juan Misael Sánchez Pacheco
+ * Fecha:       17 de octubre de 2026
+ * Versión:     1.0
+ */
+static uint64_t mezclarSplitMix64(uint64_t *estado)
+{
+    uint64_t z = (*estado += 0x9E3779B97F4A7C15ULL);
+
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
@@ -0,0 +1,65 @@
+/*
+ * FreeRTOS V202112.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+#ifndef ALEATORIO_H
+    #define ALEATORIO_H
+
+    #include <stdint.h>
+
+    #ifdef __cplusplus
+        extern "C" {
+    #endif
+
+/*-----------------------------------------------------------
+* Generador de números aleatorios propio de cada tarea.
+*----------------------------------------------------------*/
+
+    // Estado de un generador xoshiro256++. Cada tarea tiene el suyo, así que no
+    // se comparte estado entre tareas ni hace falta exclusión mutua.
+    typedef struct {
+
+        uint64_t estado[4];
+
+    } GeneradorAleatorio;
+
+    void iniciarAleatorio( void );
+    void sembrarAleatorio( GeneradorAleatorio * generador,
+                           uint64_t semilla,
+                           uint64_t flujo );
+    uint64_t generarAleatorio( GeneradorAleatorio * generador );
+    double generarUniforme( GeneradorAleatorio * generador );
+    double generarNormal( GeneradorAleatorio * generador );
+    void generarNormales( GeneradorAleatorio * generador,
+                          double * valores,
+                          int total,
+                          double media,
+                          double desviacion );
+
+    #ifdef __cplusplus
+        }
+    #endif
+
+#endif /* ALEATORIO_H */
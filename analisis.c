@@ -0,0 +1,235 @@
+/*
+ * FreeRTOS V202112.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+ /***************************************************************************************
+ * Módulo:              Núcleos de análisis de las muestras de las T3.x.                *
+ *                                                                                      *
+ *                      Cuentan cuántas muestras superan un umbral en valor             *
+ *                      absoluto y paran en cuanto se alcanza un mínimo. Procesan       *
+ *                      bloques de MUESTRAS_POR_BLOQUE muestras sin saltos (valor       *
+ *                      absoluto, comparación y recuento de bits) y solo comprueban     *
+ *                      el corte y el abandono al final de cada bloque.                 *
+ *                                                                                      *
+ *                      En x86 se elige al ejecutar la versión AVX2 o SSE2 según la     *
+ *                      CPU; en otras arquitecturas se usa la versión escalar.          *
+ *                                                                                      *
+ * Autor:               Juan Misael Sánchez Pacheco                                     *
+ * Fecha:               17 de octubre de 2026                                           *
+ * Versión:             1.1                                                             *
+ ****************************************************************************************/
+
+
+
+
+/*-----------------------------------------------------------*/
+
+
+
+
+/* BIBLIOTECAS */
+
+/* Bibliotecas utilizadas */
+#include <math.h> // Es necesario incluir -lm al compilar.
+#include <stdbool.h>
+
+#if defined( __x86_64__ ) || defined( __i386__ )
+    #include <immintrin.h>
+#endif
+
+/* Local includes. */
+#include "analisis.h"
+
+
+
+
+/*-----------------------------------------------------------*/
+
+
+
+
+/* CONSTANTES. */
+
+// Versiones vectoriales disponibles. Se compilan con atributos target, así que no
+// hace falta compilar todo el programa con -mavx2; la CPU se comprueba al llamarlas.
+#if ( defined( __x86_64__ ) || defined( __i386__ ) ) && defined( __GNUC__ )
+    #define ANALISIS_X86 1
+#else
+    #define ANALISIS_X86 0
+#endif
+
+
+
+
+/*-----------------------------------------------------------*/
+
+
+
+
+// PROTOTIPOS DE FUNCIONES.
+
+static bool continuarRecuento(int, int, const atomic_bool *);
+static int contarEscalar(const double *, int, double, int, const atomic_bool *);
+
+#if ANALISIS_X86
+static int contarSSE2(const double *, int, double, int, const atomic_bool *);
+static int contarAVX2(const double *, int, double, int, const atomic_bool *);
+#endif
+
+
+
+
+/*-----------------------------------------------------------*/
+
+
+
+
+/*
+ * Función:         Cuenta las muestras cuyo valor absoluto supera el
+ *                  umbral, parando en el primer bloque en el que el
+ *                  recuento alcanza el mínimo o en el que se encuentra
+ *                  activo el indicador de abandono.
+ *
+ * Autor:           Juan Misael Sánchez Pacheco
+ * Fecha:           17 de octubre de 2026
+ * Versión:         1.1
+ * Observaciones:   El recuento puede pasar del mínimo dentro del último
+ *                  bloque; lo que importa es si lo alcanza. Las muestras
+ *                  NaN nunca superan el umbral. El indicador de abandono
+ *                  puede ser NULL; si se activa, el recuento se queda en
+ *                  las muestras de los bloques ya procesados.
+ */
+int contarSuperanUmbral(const double *valores, int total, double umbral, int minimo, const atomic_bool *abandonar)
+{
+#if ANALISIS_X86
+    if (__builtin_cpu_supports("avx2")) return contarAVX2(valores, total, umbral, minimo, abandonar);
+    if (__builtin_cpu_supports("sse2")) return contarSSE2(valores, total, umbral, minimo, abandonar);
+#endif
+    return contarEscalar(valores, total, umbral, minimo, abandonar);
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:     Indica si se puede procesar otro bloque: el recuento
+ *              no ha llegado al mínimo y no se ha pedido el abandono.
+ *
+ * Autor:       Juan Misael Sánchez Pacheco
+ * Fecha:       17 de octubre de 2026
+ * Versión:     1.0
+ */
+static inline bool continuarRecuento(int recuento, int minimo, const atomic_bool *abandonar)
+{
+    return recuento < minimo && (abandonar == NULL || !atomic_load_explicit(abandonar, memory_order_acquire));
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:     Recuento escalar, para CPUs sin SIMD y para las
+ *              muestras que no completan un vector.
+ *
+ * Autor:       Juan Misael Sánchez Pacheco
+ * Fecha:       17 de octubre de 2026
+ * Versión:     1.0
+ */
+static int contarEscalar(const double *valores, int total, double umbral, int minimo, const atomic_bool *abandonar)
+{
+    int recuento = 0;
+
+    for (int inicio = 0; inicio < total && continuarRecuento(recuento, minimo, abandonar); inicio += MUESTRAS_POR_BLOQUE)
+    {
+        int fin = inicio + MUESTRAS_POR_BLOQUE < total ? inicio + MUESTRAS_POR_BLOQUE : total;
+        for (int i = inicio; i < fin; i++) recuento += fabs(valores[i]) > umbral;
+    }
+
+    return recuento;
+}
+
+#if ANALISIS_X86
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:         Recuento con SSE2: dos muestras por vector. El valor
+ *                  absoluto se obtiene borrando el bit de signo y la
+ *                  comparación da una máscara cuyos bits se cuentan.
+ *
+ * Autor:           Juan Misael Sánchez Pacheco
+ * Fecha:           17 de octubre de 2026
+ * Versión:         1.0
+ * Observaciones:   Las muestras que no llenan un bloque completo se
+ *                  cuentan con la versión escalar.
+ */
+__attribute__(( target( "sse2" ) ))
+static int contarSSE2(const double *valores, int total, double umbral, int minimo, const atomic_bool *abandonar)
+{
+    const __m128d signo = _mm_set1_pd(-0.0);
+    const __m128d limite = _mm_set1_pd(umbral);
+    int recuento = 0, inicio = 0;
+
+    for ( ; inicio + MUESTRAS_POR_BLOQUE <= total && continuarRecuento(recuento, minimo, abandonar); inicio += MUESTRAS_POR_BLOQUE)
+    {
+        for (int i = inicio; i < inicio + MUESTRAS_POR_BLOQUE; i += 2)
+        {
+            __m128d absoluto = _mm_andnot_pd(signo, _mm_loadu_pd(&valores[i]));
+            recuento += __builtin_popcount(_mm_movemask_pd(_mm_cmpgt_pd(absoluto, limite)));
+        }
+    }
+
+    if (recuento < minimo) recuento += contarEscalar(&valores[inicio], total - inicio, umbral, minimo - recuento, abandonar);
+    return recuento;
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:     Recuento con AVX2: cuatro muestras por vector.
+ *
+ * Autor:       Juan Misael Sánchez Pacheco
+ * Fecha:       17 de octubre de 2026
+ * Versión:     1.0
+ */
+__attribute__(( target( "avx2" ) ))
+static int contarAVX2(const double *valores, int total, double umbral, int minimo, const atomic_bool *abandonar)
+{
+    const __m256d signo = _mm256_set1_pd(-0.0);
+    const __m256d limite = _mm256_set1_pd(umbral);
+    int recuento = 0, inicio = 0;
+
+    for ( ; inicio + MUESTRAS_POR_BLOQUE <= total && continuarRecuento(recuento, minimo, abandonar); inicio += MUESTRAS_POR_BLOQUE)
+    {
+        for (int i = inicio; i < inicio + MUESTRAS_POR_BLOQUE; i += 4)
+        {
+            __m256d absoluto = _mm256_andnot_pd(signo, _mm256_loadu_pd(&valores[i]));
+            recuento += __builtin_popcount(_mm256_movemask_pd(_mm256_cmp_pd(absoluto, limite, _CMP_GT_OQ)));
+        }
+    }
+
+    if (recuento < minimo) recuento += contarEscalar(&valores[inicio], total - inicio, umbral, minimo - recuento, abandonar);
+    return recuento;
+}
+
+#endif /* ANALISIS_X86 */
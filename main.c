@@ -42,6 +42,7 @@
 #include <stdarg.h>
 #include <signal.h>
 #include <errno.h>
+#include <time.h>
 #include <sys/select.h>
 
 /* FreeRTOS kernel includes. */
@@ -50,6 +51,7 @@
 
 /* Local includes. */
 #include "console.h"
+#include "planificador.h"
 
 #ifdef BUILD_DIR
     #define BUILD         BUILD_DIR
@@ -60,6 +62,12 @@
 
 /* This demo uses heap_3.c (the libc provided malloc() and free()). */
 
+/* Upper bound of a single idle sleep, used when no release is known.  It was the
+ * fixed sleep of the idle hook. */
+#define mainMAX_IDLE_SLEEP_US        15000ULL
+
+#define mainMICROSECONDS_PER_TICK    ( 1000000ULL / configTICK_RATE_HZ )
+
 /*-----------------------------------------------------------*/
 extern void main_base( void );
 static void traceOnEnter( void );
@@ -91,6 +99,19 @@ void vApplicationGetTimerTaskMemory( StaticTask_t ** ppxTimerTaskTCBBuffer,
  */
 static void prvSaveTraceFile( void );
 
+/*
+ * Returns the monotonic clock in microseconds.  It is the time base of the run
+ * time counter used by the LLF scheduler to account execution time.
+ */
+static unsigned long long prvGetMonotonicMicroseconds( void );
+
+/*
+ * Sleeps the idle task until the given number of ticks after the last tick
+ * interrupt, and reports the time slept and the wake-up latency to the LLF
+ * scheduler statistics.
+ */
+static void prvIdleSleep( TickType_t xTicks );
+
 /*
  * Signal handler for Ctrl_C to cause the program to exit, and generate the
  * profiling info.
@@ -106,6 +127,14 @@ static void handle_sigint( int signal );
  * in a different file. */
 StackType_t uxTimerTaskStack[ configTIMER_TASK_STACK_DEPTH ];
 
+/* Microsecond time stamp of the moment the run time counter was configured.
+ * ulGetRunTimeCounterValue() counts from this point. */
+static unsigned long long ullRunTimeCounterBase = 0ULL;
+
+/* Monotonic time stamp, in microseconds, of the last tick interrupt.  Releases
+ * happen on tick boundaries, so the idle task sleeps relative to it. */
+static volatile unsigned long long ullLastTickMicroseconds = 0ULL;
+
 /* Notes if the trace is running or not. */
 #if ( projCOVERAGE_TEST == 1 )
     static BaseType_t xTraceRunning = pdFALSE;
@@ -139,6 +168,10 @@ int main( void )
     #endif /* if ( projCOVERAGE_TEST != 1 ) */
 
     console_init();
+
+    /* The LLF scheduler accounts execution time with the run time counter, so it
+     * must be running before any task is switched in. */
+    vConfigureTimerForRunTimeStats();
     
     console_print( "Starting PCyTR demo\n" );
     main_base();
@@ -177,8 +210,21 @@ void vApplicationIdleHook( void )
      * because it is the responsibility of the idle task to clean up memory
      * allocated by the kernel to any task that has since deleted itself. */
 
+    /* Free the scheduling data of the tasks removed from the LLF registry.  The
+     * idle task only runs once they can no longer be scheduled. */
+    liberarTareasEliminadasLLF();
+
+    /* Sleep until the next release announced by the periodic tasks or the next
+     * wake-up of the LLF controller instead of a fixed 15 ms, which delayed
+     * releases and added jitter.  Any signal, such as the tick interrupt that
+     * unblocks a task waiting on a queue or a delay, ends the sleep early. */
+    TickType_t xTicks = calcularEsperaInactividadLLF();
+
+    if( xTicks > 0 )
+    {
+        prvIdleSleep( xTicks );
+    }
 
-    usleep( 15000 );
     traceOnEnter();
 }
 /*-----------------------------------------------------------*/
@@ -205,6 +251,9 @@ void vApplicationTickHook( void )
     * added here, but the tick hook is called from an interrupt context, so
     * code must not attempt to block, and only the interrupt safe FreeRTOS API
     * functions can be used (those that end in FromISR()). */
+
+    /* clock_gettime() is async-signal-safe. */
+    ullLastTickMicroseconds = prvGetMonotonicMicroseconds();
 }
 
 void traceOnEnter()
@@ -233,6 +282,70 @@ void traceOnEnter()
     #endif /* if ( TRACE_ON_ENTER == 1 ) */
 }
 
+static unsigned long long prvGetMonotonicMicroseconds( void )
+{
+    struct timespec xNow;
+
+    clock_gettime( CLOCK_MONOTONIC, &xNow );
+
+    return ( unsigned long long ) xNow.tv_sec * 1000000ULL + ( unsigned long long ) xNow.tv_nsec / 1000ULL;
+}
+/*-----------------------------------------------------------*/
+
+static void prvIdleSleep( TickType_t xTicks )
+{
+    unsigned long long ullStart = prvGetMonotonicMicroseconds();
+    unsigned long long ullTarget = ullStart + mainMAX_IDLE_SLEEP_US;
+    unsigned long long ullEnd;
+    struct timespec xTarget;
+    BaseType_t xEarly;
+    uint32_t ulLatency = 0UL;
+
+    /* The release is due xTicks after the last tick interrupt.  If no release is
+     * known the sleep is bounded as before. */
+    if( ( xTicks != portMAX_DELAY ) &&
+        ( ullLastTickMicroseconds + ( unsigned long long ) xTicks * mainMICROSECONDS_PER_TICK < ullTarget ) )
+    {
+        ullTarget = ullLastTickMicroseconds + ( unsigned long long ) xTicks * mainMICROSECONDS_PER_TICK;
+    }
+
+    if( ullTarget <= ullStart )
+    {
+        return;
+    }
+
+    xTarget.tv_sec = ( time_t ) ( ullTarget / 1000000ULL );
+    xTarget.tv_nsec = ( long ) ( ( ullTarget % 1000000ULL ) * 1000ULL );
+
+    /* An absolute deadline does not drift if the sleep is resumed. */
+    xEarly = ( clock_nanosleep( CLOCK_MONOTONIC, TIMER_ABSTIME, &xTarget, NULL ) == EINTR ) ? pdTRUE : pdFALSE;
+    ullEnd = prvGetMonotonicMicroseconds();
+
+    if( ( xEarly == pdFALSE ) && ( ullEnd > ullTarget ) )
+    {
+        ulLatency = ( uint32_t ) ( ullEnd - ullTarget );
+    }
+
+    registrarInactividadLLF( ( uint32_t ) ( ullEnd - ullStart ), ulLatency, xEarly == pdTRUE );
+}
+/*-----------------------------------------------------------*/
+
+void vConfigureTimerForRunTimeStats( void )
+{
+    /* The POSIX port has no hardware timer to configure, the monotonic clock
+     * is used instead.  Only its current value is taken as the counter origin. */
+    ullRunTimeCounterBase = prvGetMonotonicMicroseconds();
+}
+/*-----------------------------------------------------------*/
+
+unsigned long ulGetRunTimeCounterValue( void )
+{
+    /* Microseconds since vConfigureTimerForRunTimeStats() was called.  This is
+     * called from inside the context switch, so it must not block. */
+    return ( unsigned long ) ( prvGetMonotonicMicroseconds() - ullRunTimeCounterBase );
+}
+/*-----------------------------------------------------------*/
+
 void vLoggingPrintf( const char * pcFormat,
                      ... )
 {
@@ -25,12 +25,12 @@
  */
 
  /***************************************************************************************
- * Programa:            De manera periódica se genera un archivo de texto               *
- *                      con nombre aleatorio en el que se escriben números              *
- *                      decimales que siguen una distribución normal con media          *
- *                      tendiente a cero y desviación estándar unitaria.                *
+ * Programa:            De manera periódica se rellena un buffer de muestras            *
+ *                      en memoria con números decimales que siguen una                 *
+ *                      distribución normal con media tendiente a cero y                *
+ *                      desviación estándar unitaria.                                   *
  *                                                                                      *
- *                      Ese archivo se distribuye entre varias tareas cuya              *
+ *                      Ese buffer se comparte entre varias tareas cuya                 *
  *                      labor es contar si los valores absolutos de los números         *
  *                      superan cierto un umbral y devolver un resultado binario        *
  *                      en base a la cantidad de valores que superan la prueba.         *
@@ -41,7 +41,7 @@
  *                                                                                      *
  * Autor:               Juan Misael Sánchez Pacheco                                     *
  * Fecha:               16 de mayo de 2025                                              *
- * Versión:             1.0                                                             *
+ * Versión:             1.1                                                             *
  ****************************************************************************************/
 
 
@@ -66,10 +66,15 @@
 #include "FreeRTOS.h"
 #include "task.h"
 #include "timers.h"
-#include "semphr.h"
+#include "queue.h"
 
 /* Local includes. */
 #include "console.h"
+#include "planificador.h"
+#include "modelo_tareas.h"
+#include "muestras.h"
+#include "analisis.h"
+#include "aleatorio.h"
 
 
 
@@ -81,50 +86,16 @@
 
 /* CONSTANTES. */
 
-// Prioridad base para todas las tareas.
-#define PRIORIDAD_BASE 1 
-
-// Prioridad máxima para el planificador LLF. 
-#define PRIORIDAD_CONTROLADOR   configMAX_PRIORITIES - 1 
-
-// Periodos de las tareas (T) periódicas
-#define PERIODO_T1  pdMS_TO_TICKS( 1000UL ) // 1000 ms.
-#define PERIODO_T4  pdMS_TO_TICKS( 2000UL ) // 2000 ms.
-#define PERIODO_LLF pdMS_TO_TICKS( 1UL )    // 1 ms.
-
-// Plazos de ejecución para las tareas (D).
-#define PLAZO_T1    pdMS_TO_TICKS( 300UL )  // 300 ms.
-#define PLAZO_T2    pdMS_TO_TICKS( 1000UL ) // 1000 ms.
-#define PLAZO_T3x   pdMS_TO_TICKS( 500UL )  // 500 ms.
-#define PLAZO_T4    pdMS_TO_TICKS( 2000UL ) // 2000 ms.
-
-// Tiempos de ejecución (C)
-#define EJECUCION_T1    pdMS_TO_TICKS( 100UL )  // 100 ms.
-#define EJECUCION_T2    pdMS_TO_TICKS( 100UL )  // 100 ms.
-#define EJECUCION_T3x   pdMS_TO_TICKS( 50UL )   // 50 ms.
-#define EJECUCION_T4    pdMS_TO_TICKS( 500UL  ) // 500 ms.
-
-// Cantidad total de tareas (T1, T2, T3.x y T4).
-#define TOTAL_TAREAS 12 
-
-// Cantidad de tareas T3.x
-#define TAREAS_SECUNDARIAS 9 
-
-// Índice para recoger las tareas T3.x 
-// para el planificador LLF.
-#define POS_TAREAS_SECUNDARIAS 3 
-
-// Cantidad total de caracteres para los 
-// nombres de los archivos.
-#define TOTAL_CARACTERES 13 
+// Los periodos (T), plazos (D) y tiempos de ejecución (C) de las
+// tareas están en modelo_tareas.h, que comparte el simulador.
 
 // Cantidad de caracteres para el nombre 
 // de las tareas T3.x
 #define CARACTERES_TAREA 5 
 
-// Cantidad de número decimales que se 
-// imprimen en el archivo.
-#define NUMEROS_DECIMALES 200 
+// Cantidad de número decimales que se
+// generan en cada buffer de muestras.
+#define NUMEROS_DECIMALES MUESTRAS_POR_BUFFER
 
 // // Media para la distribución normal.
 #define MEDIA 0 
@@ -133,8 +104,8 @@
 // distribución normal.
 #define DESVIACION 1 
 
-// Umbral que deben superar los valores 
-// impresos en el archivo.
+// Umbral que deben superar los valores
+// de las muestras.
 #define UMBRAL 2 
 
 // Cantidad de valores mínimo que deben 
@@ -145,6 +116,103 @@
 // el resultado desde T3.x
 #define PROBABILIDAD_EXITO 0.8
 
+// Cantidad de consensos entre dos informes
+// de las estadísticas del planificador.
+#define CONSENSOS_INFORME 10
+
+// Espera antes de volver a pedir la admisión
+// de un trabajo aplazado.
+#define RETARDO_ADMISION pdMS_TO_TICKS( 10UL ) // 10 ms.
+
+// Medida ante un sobrecoste o un plazo vencido de T4, cuya espera
+// activa le quitaría CPU a las tareas del consenso, y ejecución que
+// se le tolera por encima de EJECUCION_T4.
+#define SOBRECOSTE_T4   SOBRECOSTE_ABORTAR
+#define MARGEN_T4       pdMS_TO_TICKS( 0UL ) // 0 ms.
+
+// Espera activa que se añade a cada trabajo de T4 por encima de
+// EJECUCION_T4, en ms (make EXCESO_T4=<ms>). Sin ella la espera termina
+// antes de agotar el presupuesto y SOBRECOSTE_T4 nunca llega a actuar.
+#ifndef EXCESO_T4
+    #define EXCESO_T4 0
+#endif
+
+// Archivo de auditoría de las muestras de cada trabajo: ninguno
+// (FORMATO_MEMORIA), texto (FORMATO_TEXTO) o binario (FORMATO_BINARIO).
+// Con archivo, T2 lo carga una vez y las T3.x analizan esa carga.
+#ifndef FORMATO_MUESTRAS
+    #define FORMATO_MUESTRAS FORMATO_MEMORIA
+#endif
+
+// Transmisión por fragmentos: T1 envía el buffer antes de generarlo y
+// las T3.x analizan cada fragmento en cuanto se publica. Con ella el
+// archivo de auditoría, si lo hay, se escribe al final y no se carga.
+#ifndef MUESTRAS_EN_FRAGMENTOS
+    #define MUESTRAS_EN_FRAGMENTOS 0
+#endif
+
+// Réplicas T3.x que analizan cada parte de las muestras. Con TAREAS_SECUNDARIAS
+// todas analizan todas las muestras y T2 vota (tolerancia a fallos); con 1 cada
+// T3.x analiza una parte distinta y T2 suma sus recuentos (rendimiento). Los
+// valores intermedios combinan ambos: varias réplicas redundantes por parte.
+#ifndef REPLICAS_POR_PARTE
+    #define REPLICAS_POR_PARTE TAREAS_SECUNDARIAS
+#endif
+
+#if REPLICAS_POR_PARTE < 1 || REPLICAS_POR_PARTE > TAREAS_SECUNDARIAS
+    #error REPLICAS_POR_PARTE debe estar entre 1 y TAREAS_SECUNDARIAS.
+#endif
+
+// Trabajos que pueden estar en curso a la vez en T2, que también son los que
+// caben en la cola hacia T2.
+#define TRABAJOS_EN_CURSO 3
+
+// Cada trabajo de la cola y cada trabajo en curso retienen un buffer, y T1
+// rellena otro: si faltaran, T1 se quedaría sin buffer antes de que se llenara
+// la cola y la política de saturación no llegaría a aplicarse.
+#if TOTAL_BUFFERS_MUESTRAS < 2 * TRABAJOS_EN_CURSO + 1
+    #error La reserva de muestras necesita al menos 2 * TRABAJOS_EN_CURSO + 1 buffers.
+#endif
+
+// Plazo de extremo a extremo de cada trabajo, desde la activación de T1
+// hasta que T2 imprime su consenso.
+#define PLAZO_CONSENSO ( PLAZO_T1 + PLAZO_T2 )
+
+// Medida que toma T1 cuando la cola hacia T2 está llena (ver PoliticaSaturacion).
+#ifndef POLITICA_SATURACION
+    #define POLITICA_SATURACION SATURACION_DESCARTAR_ANTIGUO
+#endif
+
+// Réplicas que se activan por trabajo con SATURACION_DEGRADAR mientras haya
+// trabajos esperando en la cola hacia T2.
+#define REPLICAS_DEGRADADAS 3
+
+// Replicación adaptativa en la votación (REPLICAS_POR_PARTE == TAREAS_SECUNDARIAS):
+// T2 pondera cada voto por la fiabilidad observada de su T3.x, empieza con las
+// réplicas justas para alcanzar CONFIANZA_OBJETIVO si coinciden y solo lanza más
+// si discrepan. Con 0 se vota por mayoría absoluta entre todas las admitidas.
+#ifndef REPLICACION_ADAPTATIVA
+    #define REPLICACION_ADAPTATIVA 1
+#endif
+
+#define VOTACION_PONDERADA ( REPLICACION_ADAPTATIVA && REPLICAS_POR_PARTE == TAREAS_SECUNDARIAS )
+
+// Confianza con la que se decide: la de la mayoría absoluta de 9 réplicas
+// que aciertan con PROBABILIDAD_EXITO, P(Bin(9, 0.8) >= 5) = 0.98.
+#define CONFIANZA_OBJETIVO 0.98
+
+// Votos ficticios con PROBABILIDAD_EXITO con los que empieza la fiabilidad
+// de cada T3.x, para que unas pocas observaciones no la disparen.
+#define VOTOS_FIABILIDAD_PREVIA 20
+
+// Fiabilidad máxima que se atribuye a una T3.x: ningún voto decide solo.
+#define FIABILIDAD_MAXIMA 0.95
+
+// Cada réplica ocupa un bit de las máscaras de la votación.
+#if TAREAS_SECUNDARIAS > 32
+    #error Las máscaras de la votación tienen 32 bits: como mucho 32 tareas T3.x.
+#endif
+
 
 
 
@@ -155,33 +223,130 @@
 
 /* VARIABLES Y DATOS. */
 
-// Estructura para agrupar los datos de cada tarea necesarios 
-// para la planificación LLF.
+// Medidas ante la saturación de la cola hacia T2, cuando T2 no da abasto.
+typedef enum {
+
+    SATURACION_BLOQUEAR, // T1 espera a que haya sitio (comportamiento original).
+    SATURACION_DESCARTAR_ANTIGUO, // Se descarta el trabajo más antiguo de la cola.
+    SATURACION_DESCARTAR_NUEVO, // Se descarta el trabajo nuevo.
+    SATURACION_FUSIONAR, // Los trabajos pendientes se sustituyen por el nuevo.
+    SATURACION_DEGRADAR // Se descarta el nuevo y T2 usa menos réplicas hasta vaciar la cola.
+
+} PoliticaSaturacion;
+
+// Trabajos descartados o recortados por la política de saturación.
+static struct {
+
+    atomic_uint descartados_antiguos; // Trabajos antiguos sacados de la cola.
+    atomic_uint descartados_nuevos; // Trabajos nuevos que no han entrado en la cola.
+    atomic_uint fusionados; // Trabajos pendientes sustituidos por uno nuevo.
+    atomic_uint degradados; // Trabajos analizados con REPLICAS_DEGRADADAS réplicas.
+    atomic_uint sin_buffer; // Trabajos de T1 descartados por no haber buffers de muestras libres.
+
+} saturacion;
+
+// Votación de un trabajo, dentro de su TrabajoConsenso. Cada réplica tiene un bit en las
+// máscaras y marca el de su respuesta; solo despierta a T2 cuando un valor
+// alcanza la mayoría o cuando responde la última réplica.
+typedef struct {
+
+    atomic_uint si; // Réplicas que han respondido true.
+    atomic_uint no; // Réplicas que han respondido false.
+    atomic_uint abandonadas; // Réplicas sin voto: T2 ya había decidido o su activación se omitió.
+    atomic_int respuestas; // Réplicas que han respondido, con cualquier valor.
+    atomic_bool decidido; // T2 ya ha decidido: las réplicas pendientes pueden abandonar.
+    int recuentos[TAREAS_SECUNDARIAS]; // Recuento de cada réplica, escrito antes de marcar su bit.
+    DatosTarea *tareas[TAREAS_SECUNDARIAS]; // T3.x que ha respondido por cada réplica, escrita antes de marcar su bit.
+    int replicas; // Réplicas del trabajo.
+    int mayoria; // Votos de un mismo valor con los que se decide (más que replicas en el reparto).
+
+} Votacion;
+
+// Descriptor de un trabajo, que T1 envía a T2 por valor.
+typedef struct {
+
+    uint32_t id; // Identificador del trabajo, el mismo que el de sus muestras.
+    TickType_t liberacion; // Activación de T1 en la que se generó.
+    TickType_t plazo; // Plazo absoluto de extremo a extremo (PLAZO_CONSENSO).
+    BufferMuestras *muestras; // Buffer de muestras, con una referencia para T2.
+
+} DescriptorTrabajo;
+
+// Etapa de un trabajo en T2.
+typedef enum {
+
+    TRABAJO_LIBRE, // El hueco no tiene trabajo.
+    TRABAJO_ADMISION, // Recibido de T1, pendiente de la admisión del trabajo de T2.
+    TRABAJO_REPLICAS, // Admitido, pendiente de la admisión de sus réplicas T3.x.
+    TRABAJO_VOTACION // Réplicas lanzadas: T2 revisa su votación.
+
+} EtapaTrabajo;
+
+// Trabajo en curso en T2: su descriptor y su votación. Solo T2 los reserva y
+// los libera; las réplicas acceden a la votación hasta que responden.
 typedef struct {
 
-    TaskHandle_t handle; // Handle de cada tarea.
-    TickType_t instante_activacion; // Instante de activación de cada tarea.
-    TickType_t plazo_ejecucion; // Plazo de ejecución de cada tarea.
-    TickType_t ejecucion_restante; // Tiempo de ejecución restante por completar.
-    TickType_t holgura; // Holgura actual de la tarea.
-    bool activa; // Indicativo de activación de la tarea.
+    DescriptorTrabajo descriptor;
+    Votacion votacion;
+    int partes; // Partes en las que se reparten las muestras.
+    bool decidido; // El consenso ya se ha impreso.
+    EtapaTrabajo etapa; // Etapa del trabajo (TRABAJO_LIBRE si el hueco está libre).
+    bool aplazado; // El control de admisión aplazó la etapa: se reintenta en el siguiente despertar de T2.
 
-} DatosTarea;
+} TrabajoConsenso;
 
-// Información de las tareas.
-DatosTarea datos_tareas[TOTAL_TAREAS];
+// Petición de análisis que T2 envía a una T3.x: el trabajo, el buffer y la
+// parte de sus muestras que le toca.
+typedef struct {
 
-// Registro de la última tarea ejecutada.
-TaskHandle_t tarea_ejecutada = NULL, tarea_LLF = NULL;
-TickType_t inicio_ejecucion = 0;
+    uint32_t trabajo; // Identificador del trabajo (DescriptorTrabajo).
+    TickType_t plazo; // Plazo absoluto de extremo a extremo del trabajo.
+    BufferMuestras *muestras; // Buffer compartido, con una referencia para la T3.x.
+    int parte; // Índice de la parte.
+    int inicio; // Primera muestra de la parte.
+    int fin; // Posición siguiente a la última muestra de la parte.
+    TickType_t ejecucion; // Ejecución prevista para analizar la parte.
+    int replica; // Bit de la réplica en las máscaras de la votación.
+    Votacion *votacion; // Votación del trabajo, válida hasta que responde la réplica.
+    TaskHandle_t coordinadora; // Tarea a la que se notifica (T2).
+
+} PeticionAnalisis;
+
+// Fiabilidad observada de una T3.x: cuántos de sus votos coincidieron
+// con el consenso. Solo T2 la consulta y la actualiza.
+typedef struct {
 
-// Colas de comunicación entre tareas.
+    uint32_t acuerdos; // Votos que coincidieron con el consenso.
+    uint32_t votos; // Votos emitidos en las votaciones ponderadas.
+
+} FiabilidadReplica;
+
+// Colas de comunicación entre tareas. Las T3.x responden en la votación de
+// cada trabajo (Votacion), no por una cola.
 QueueHandle_t cola_T1_T2 = NULL, 
-              cola_T2_T3x = NULL, 
-              cola_T3x_T2 = NULL;
+              cola_T2_T3x = NULL;
+
+// Semilla de aleatoriedad, que se guarda con las muestras. Con ella y el trabajo
+// se pueden volver a generar las mismas muestras.
+static uint32_t semilla = 0;
+
+// Datos de T2, a la que T1 avisa de cada trabajo nuevo.
+static DatosTarea *datos_T2 = NULL;
+
+// Respuestas de las réplicas T3.x después del plazo de su trabajo.
+static atomic_uint respuestas_fuera_de_plazo = 0;
 
-// Semáforo para el LLF.
-SemaphoreHandle_t semaforo = NULL;
+// Fiabilidad de cada T3.x, en el orden de sus datos en T2.
+static FiabilidadReplica fiabilidad[TAREAS_SECUNDARIAS];
+
+// Réplicas lanzadas en las votaciones ponderadas, para las estadísticas. Solo T2.
+static struct {
+
+    uint32_t trabajos; // Trabajos decididos.
+    uint32_t replicas; // Réplicas lanzadas entre todos ellos.
+    uint32_t escaladas; // Veces que se han lanzado réplicas adicionales.
+
+} replicacion;
 
 
 /*-----------------------------------------------------------*/
@@ -192,18 +357,30 @@ SemaphoreHandle_t semaforo = NULL;
 // PROTOTIPOS DE FUNCIONES.
 
  // Tareas.
-static void xLLFCode( void * pvParameters );
 static void xT1Code( void * pvParameters );
 static void xT2Code( void * pvParameters );
 static void xT3Code( void * pvParameters );
 static void xT4Code( void * pvParameters );
 
 // Funciones auxiliares.
-static int calcularHolgura(DatosTarea, TickType_t);
-static void recalcularPrioridades(void);
-static void generarNombreAleatorio(char*);
-static double generarAleatorioNormal(void);
-static void imprimirResultado(int);
+static uint64_t calcularFlujoTarea(const char *);
+static void enviarTrabajo(const DescriptorTrabajo *);
+static void descartarTrabajo(const DescriptorTrabajo *);
+static void admitirTrabajo(TrabajoConsenso *, DatosTarea *, TickType_t);
+static ResultadoAdmision admitirReplicas(DatosTarea **, int *);
+static void iniciarConsenso(TrabajoConsenso *, DatosTarea **);
+static bool requiereRevision(TrabajoConsenso *);
+static void enviarPeticiones(TrabajoConsenso *, int, int);
+static bool revisarConsenso(TrabajoConsenso *, DatosTarea **);
+static bool decidirVotacionPonderada(TrabajoConsenso *, DatosTarea **);
+static double calcularFiabilidad(int);
+static double calcularPesoVoto(int);
+static int calcularReplicasNecesarias(double);
+static int calcularMediana(int *, int);
+static void imprimirResultado(const DescriptorTrabajo *, int, int, int);
+static void imprimirRecuento(const DescriptorTrabajo *, int, int, int);
+static void imprimirResultadoPonderado(const DescriptorTrabajo *, bool, double, int, int);
+static void imprimirEstadisticas(void);
 
 
 
@@ -218,28 +395,34 @@ static void imprimirResultado(int);
  */
 void main_base( void )
 {
-    // Semilla de aleatoriedad.
-    srand(time(NULL));
-
-    // Creación del semáforo para el LLF.
-    semaforo = xSemaphoreCreateMutex();
-
-    // Inicialización de los datos de las tareas a cero.
-    for (int i = 0; i < TOTAL_TAREAS; i++)
-        memset(&datos_tareas[i], 0, sizeof(DatosTarea));
+    // Semilla de aleatoriedad, elegida al arrancar con la variable de entorno SEMILLA
+    // para repetir una ejecución. Sin ella se usa la hora.
+    const char *texto_semilla = getenv("SEMILLA");
+    semilla = texto_semilla != NULL ? (uint32_t) strtoul(texto_semilla, NULL, 0) : (uint32_t) time(NULL);
+
+    // Tablas del generador de muestras normales, que las tareas comparten sin modificarlas.
+    iniciarAleatorio();
+
+    // Creación del registro de tareas y de la tarea del planificador LLF.
+    iniciarPlanificadorLLF();
+
+    // Política de planificación elegida al arrancar con la variable de entorno POLITICA
+    // (LLF, EDF, RM, DM o EDZL). Sin ella se usa la elegida al compilar.
+    PoliticaPlanificacion politica;
+    const char *nombre_politica = getenv("POLITICA");
+    if (nombre_politica != NULL && buscarPoliticaPlanificacion(nombre_politica, &politica))
+        seleccionarPoliticaPlanificacion(politica);
     
-    // Creación de las tareas principales.
-    xTaskCreate( xT1Code, "T1", configMINIMAL_STACK_SIZE, &datos_tareas[0], PRIORIDAD_BASE, &datos_tareas[0].handle );
-    xTaskCreate( xT2Code, "T2", configMINIMAL_STACK_SIZE, &datos_tareas[1], PRIORIDAD_BASE, &datos_tareas[1].handle );
-    xTaskCreate( xT4Code, "T4", configMINIMAL_STACK_SIZE, &datos_tareas[2], PRIORIDAD_BASE, &datos_tareas[2].handle );
-
-    // configMAX_PRIORITIES se modifica en FreeRTOSConfig.h para poder asignar una prioridad a cada tarea.
-    xTaskCreate( xLLFCode, "LLF", configMINIMAL_STACK_SIZE, NULL, PRIORIDAD_CONTROLADOR, &tarea_LLF );
+    // Creación de las tareas principales. T2 se activa una vez por periodo de T1.
+    crearTareaLLF( xT1Code, "T1", PLAZO_T1, PERIODO_T1 );
+    datos_T2 = crearTareaLLF( xT2Code, "T2", PLAZO_T2, PERIODO_T1 );
+    DatosTarea *datos_T4 = crearTareaLLF( xT4Code, "T4", PLAZO_T4, PERIODO_T4 );
+    if (datos_T4 != NULL) configurarSobrecosteLLF( datos_T4, SOBRECOSTE_T4, MARGEN_T4 );
 
-    // Creación de las colas de comunicación.
-    cola_T1_T2 = xQueueCreate(1, sizeof(char)*TOTAL_CARACTERES);
-    cola_T2_T3x = xQueueCreate(TAREAS_SECUNDARIAS, sizeof(char)*TOTAL_CARACTERES);
-    cola_T3x_T2 = xQueueCreate(TAREAS_SECUNDARIAS, sizeof(bool));
+    // Creación de las colas de comunicación. Las muestras viajan como la dirección de su buffer,
+    // dentro del descriptor de su trabajo.
+    cola_T1_T2 = xQueueCreate(TRABAJOS_EN_CURSO, sizeof(DescriptorTrabajo));
+    cola_T2_T3x = xQueueCreate(TAREAS_SECUNDARIAS * TRABAJOS_EN_CURSO, sizeof(PeticionAnalisis));
 
     // Arranque del planificador.
     vTaskStartScheduler();
@@ -256,68 +439,15 @@ void main_base( void )
 
 
 /*
- * Tarea:       Planificador personalizado que utiliza
- *              un sistema de planificación LLF (Least Laxity 
- *              First).
-
- * Autor:       Juan Misael Sánchez Pacheco
- * Fecha:       16 de mayo de 2025
- * Versión:     1.0
- */
-static void xLLFCode(void * pvParameters )
-{
-    ( void ) pvParameters;
-
-    // Se actualiza con el último instante de activación
-    // para poder controlar su periodo.
-    TickType_t ultima_activacion = xTaskGetTickCount();
-
-    while(true)
-    { 
-        // Instante de tiempo actual.
-        TickType_t t_actual = xTaskGetTickCount();
-
-        // Acceso seguro a los datos de las tareas.
-        if( xSemaphoreTake(semaforo, portMAX_DELAY) == pdTRUE )
-        {
-            // Calcular holgura para cada tarea activa y actualización del tiempo de ejecución
-            // restante para la última tarea que se estaba ejecutando.
-            for (int i = 0; i < TOTAL_TAREAS; i++) 
-            {
-                if(datos_tareas[i].activa)
-                {
-                    // Actualización del tiempo de ejecución restante de la tarea actual.
-                    if(datos_tareas[i].handle == tarea_ejecutada)
-                        datos_tareas[i].ejecucion_restante--;
-
-                    // Se calcula la holgura para las tareas activas.    
-                    datos_tareas[i].holgura = calcularHolgura(datos_tareas[i], t_actual);
-                }  
-            }
-
-            // Se establecen las prioridades tras actualizar cada holgura.
-            recalcularPrioridades();
-
-            // Se libera el semáforo.
-            xSemaphoreGive(semaforo); 
-        }
-
-        // Periodo de activación.
-        vTaskDelayUntil( &ultima_activacion, PERIODO_LLF);
-    }
-}
-
-/*-----------------------------------------------------------*/
-
-/*
- * Tarea:           Genera un archivo con números decimales
- *                  que siguen una distribución normal con
- *                  media cero y desviación estándar y le
- *                  envía el nombre del archivo a la tarea T2.
+ * Tarea:           Rellena un buffer de muestras con números
+ *                  decimales que siguen una distribución normal
+ *                  con media cero y desviación estándar y le
+ *                  envía el buffer a la tarea T2. Si se ha
+ *                  elegido, las guarda también en un archivo.
  *
  * Autor:           Juan Misael Sánchez Pacheco
  * Fecha:           16 de mayo de 2025
- * Versión:         1.0
+ * Versión:         1.9
  * Tipo de tarea:   Periódica
  */
 static void xT1Code(void * pvParameters )
@@ -325,200 +455,212 @@ static void xT1Code(void * pvParameters )
     // Se establecen los datos de la tarea T1.
     DatosTarea *datos = ( DatosTarea * ) pvParameters;
 
-    // Importante para usarlo con vTaskDelayUntil
-    TickType_t siguiente_activacion = 0; 
-    
-    // Actualización segura.
-    if( xSemaphoreTake(semaforo, portMAX_DELAY) == pdTRUE )
-    {
-        datos->plazo_ejecucion = PLAZO_T1;
-        datos->instante_activacion = xTaskGetTickCount();
-        siguiente_activacion = datos->instante_activacion; // Inicialización.
-        xSemaphoreGive(semaforo); // Se libera el semáforo.
-    }
+    // Importante para usarlo con esperarActivacionLLF (vTaskDelayUntil).
+    TickType_t siguiente_activacion = xTaskGetTickCount(); 
+
+    // Identificador del siguiente trabajo, que da nombre a su archivo de muestras.
+    uint32_t trabajo = 0;
+
+    // Generador de números aleatorios propio de T1.
+    GeneradorAleatorio generador;
 
     while(true)
     {
-        // Se toma el semáforo.
-        if( xSemaphoreTake(semaforo, portMAX_DELAY) == pdTRUE )
+        // Inicio del trabajo en este periodo: instante de activación y ejecución restante.
+        // Si la política de sobrecoste omite esta activación se espera a la siguiente.
+        if (!iniciarTrabajoLLF( datos, siguiente_activacion, EJECUCION_T1 ))
         {
-            // Se actualiza el instante de activación.
-            datos->instante_activacion = siguiente_activacion;
-
-            // Se marca como tarea activa.
-            datos->activa = true;
-
-            // Reinicio de la ejecución restante en este periodo.
-            datos->ejecucion_restante = EJECUCION_T1;
-
-            // Se libera el semáforo.
-            xSemaphoreGive(semaforo); 
+            esperarActivacionLLF( datos, &siguiente_activacion, PERIODO_T1 );
+            continue;
         }
 
-        // Generar nombre aleatorio para el archivo.
-        char nombre_archivo[TOTAL_CARACTERES] = {0};
-        generarNombreAleatorio( nombre_archivo );
-
-        // Creación/apertura del archivo en modo escritura.
-        FILE *archivo = fopen( nombre_archivo, "w" );
-
-        // Verificar si se pudo abrir correctamente
-        if (archivo == NULL) 
-        { 
-            perror( "No se pudo abrir el archivo." ); 
-            if( xSemaphoreTake(semaforo, portMAX_DELAY) == pdTRUE )
-            {
-                datos->activa = false; // Se marca como inactiva.
-                xSemaphoreGive(semaforo); // Se libera el semáforo.
-            }
-            vTaskDelayUntil( &siguiente_activacion, PERIODO_T1 );
+        // Reserva de un buffer de muestras. La reserva tiene uno por cada trabajo que
+        // puede estar en la cola o en T2, así que no debería faltar; si falta, el
+        // trabajo se descarta y cuenta como descartado por saturación.
+        BufferMuestras *muestras = reservarMuestras();
+        if (muestras == NULL)
+        {
+            atomic_fetch_add(&saturacion.sin_buffer, 1);
+            console_print("Saturación: trabajo de T1 descartado, no hay buffers de muestras libres\n");
+            finalizarTrabajoLLF( datos ); // Se marca como inactiva.
+            esperarActivacionLLF( datos, &siguiente_activacion, PERIODO_T1 );
             continue; // Se salta a la siguiente activación.
         }
 
-        // Se generan y escriben los números decimales aleatorios que siguen una
-        // distribución normal de media cero y desviación unitaria.
-        for(int i = 0; i < NUMEROS_DECIMALES; i++)
-            fprintf( archivo, "%f\n", generarAleatorioNormal() );
-        
-        // Cierre del fichero.
-        fclose( archivo );
-
-        // Envío del nombre del archivo a la cola para ejecutar T2.
-        // Espera indefinida ya que el planificador LLF gestiona el tiempo de ejecución.
-        xQueueSend( cola_T1_T2, nombre_archivo, portMAX_DELAY ); 
+        // Cada trabajo es un flujo propio del generador, así que sus muestras
+        // solo dependen de la semilla y del trabajo.
+        sembrarAleatorio(&generador, semilla, trabajo);
+        muestras->trabajo = trabajo++;
+        muestras->semilla = semilla;
+
+        // Descriptor del trabajo, con su plazo de extremo a extremo.
+        DescriptorTrabajo descriptor = {
+            .id = muestras->trabajo,
+            .liberacion = siguiente_activacion,
+            .plazo = siguiente_activacion + PLAZO_CONSENSO,
+            .muestras = muestras
+        };
+
+#if MUESTRAS_EN_FRAGMENTOS
+        // El buffer se envía antes de generarlo. T1 conserva su propia referencia
+        // mientras publica y T2 recibe otra.
+        compartirMuestras( muestras, 1 );
+        enviarTrabajo( &descriptor );
+#endif
+
+        // Se generan los números decimales aleatorios que siguen una
+        // distribución normal de media cero y desviación unitaria, publicando
+        // cada fragmento en cuanto está listo. Se para si una T3.x ya tiene su
+        // resultado o T2 ha descartado el trabajo.
+        for(int i = 0; i < NUMEROS_DECIMALES && !muestrasCanceladas(muestras); i += MUESTRAS_POR_FRAGMENTO)
+        {
+            int fragmento = NUMEROS_DECIMALES - i < MUESTRAS_POR_FRAGMENTO ? NUMEROS_DECIMALES - i : MUESTRAS_POR_FRAGMENTO;
+            generarNormales(&generador, &muestras->valores[i], fragmento, MEDIA, DESVIACION);
+            publicarMuestras(muestras, i + fragmento);
+        }
+        cerrarMuestras(muestras);
 
-        // Se toma el semáforo para actualizar.
-        if( xSemaphoreTake(semaforo, portMAX_DELAY) == pdTRUE )
+        // Archivo de auditoría, si se ha elegido. Sin él, las T3.x no tendrían qué leer.
+        if (!guardarMuestras( muestras, FORMATO_MUESTRAS ))
         {
-            // Se marca como tarea inactiva hasta el siguiente periodo de activación.
-            datos->activa = false;
-            // Reinicio de su prioridad.
-            vTaskPrioritySet(datos->handle, PRIORIDAD_BASE);
-            // Se libera el semáforo.
-            xSemaphoreGive(semaforo); 
+            liberarMuestras( muestras );
+            finalizarTrabajoLLF( datos ); // Se marca como inactiva.
+            esperarActivacionLLF( datos, &siguiente_activacion, PERIODO_T1 );
+            continue; // Se salta a la siguiente activación.
         }
 
+#if MUESTRAS_EN_FRAGMENTOS
+        // Las réplicas ya tienen sus referencias.
+        liberarMuestras( muestras );
+#else
+        // Envío del trabajo a la cola para ejecutar T2, que pasa a tener la referencia
+        // del buffer. Si T2 va con retraso se aplica la política de saturación.
+        enviarTrabajo( &descriptor );
+#endif
+
+        // Se marca como tarea inactiva hasta el siguiente periodo de activación.
+        finalizarTrabajoLLF( datos );
+
         // Periodo de activación.
-        vTaskDelayUntil( &siguiente_activacion, PERIODO_T1 );
+        esperarActivacionLLF( datos, &siguiente_activacion, PERIODO_T1 );
     }
 }
 
 /*-----------------------------------------------------------*/
 
 /*
- * Tarea:           Recibe el nombre del archivo que generó
- *                  T1, crea o activa las tareas T3.x enviándoles
- *                  el nombre del archivo y espera el resultado
- *                  de estas para poder decidir el resultado que
- *                  se imprime según el valor binario más recurrente.
+ * Tarea:           Recibe los trabajos de T1, crea o activa las
+ *                  tareas T3.x enviándoles el buffer de cada uno y
+ *                  decide el resultado que se imprime según el valor
+ *                  binario más recurrente, en cuanto tiene la mayoría
+ *                  absoluta; las réplicas pendientes abandonan entonces
+ *                  el análisis. Con la replicación adaptativa pondera
+ *                  los votos por la fiabilidad de cada T3.x y lanza más
+ *                  réplicas mientras no alcance la confianza objetivo.
+ *                  Si las muestras se reparten en partes, suma los
+ *                  recuentos de las partes. Puede tener hasta
+ *                  TRABAJOS_EN_CURSO trabajos a la vez, cada uno con su
+ *                  votación. Si el control de admisión aplaza un
+ *                  trabajo o sus réplicas, los reintenta en el
+ *                  siguiente despertar sin dejar de atender al resto.
  *
  * Autor:           Juan Misael Sánchez Pacheco
  * Fecha:           16 de mayo de 2025
- * Versión:         1.0
+ * Versión:         2.1
  * Tipo de tarea:   Esporádica
  */
 static void xT2Code(void * pvParameters )
 {
     DatosTarea *datos = (DatosTarea *) pvParameters;
 
-    if( xSemaphoreTake(semaforo, portMAX_DELAY) == pdTRUE )
-    {
-        datos->plazo_ejecucion = PLAZO_T2;
-        xSemaphoreGive(semaforo); // Se libera el semáforo.
-    }
+    // Datos de planificación de las tareas T3.x, que se crean en la primera activación.
+    DatosTarea *datos_T3x[TAREAS_SECUNDARIAS] = {NULL};
+
+    // Trabajos en curso, cada uno con su votación.
+    static TrabajoConsenso trabajos[TRABAJOS_EN_CURSO];
 
-    // Almacenamiento del nombre del archivo que le envía T1
-    // y que se envía a los T3.x.
-    char nombre_archivo[TOTAL_CARACTERES] = {0};
+    // Consensos alcanzados, para informar periódicamente del planificador.
+    int consensos = 0;
 
     while(true)
     {
-        // Se espera la recepción del nombre del archivo de forma indefinida para activarse la tarea.
-        // Es el evento de activación.
-        if( xQueueReceive(cola_T1_T2, nombre_archivo, portMAX_DELAY) == pdTRUE )
+        // Hueco libre para un trabajo nuevo, si lo hay.
+        TrabajoConsenso *hueco = NULL;
+        for(int i = 0; i < TRABAJOS_EN_CURSO && hueco == NULL; i++)
+            if(trabajos[i].etapa == TRABAJO_LIBRE) hueco = &trabajos[i];
+
+        // Se duerme hasta el siguiente aviso (un trabajo nuevo de T1 o un cruce en
+        // una votación), salvo que ya haya un trabajo esperando y sitio para él o una
+        // votación por revisar. Con etapas aplazadas, como mucho RETARDO_ADMISION.
+        // Los avisos se acumulan mientras T2 trabaja, así que no se pierde ninguno.
+        bool pendiente = hueco != NULL && uxQueueMessagesWaiting(cola_T1_T2) > 0, aplazado = false;
+        for(int i = 0; i < TRABAJOS_EN_CURSO; i++)
         {
-            if( xSemaphoreTake(semaforo, portMAX_DELAY) == pdTRUE )
-            {
-                // Instante de activación en cuanto se recibe el nombre del archivo.
-                datos->instante_activacion = xTaskGetTickCount();
-
-                // Reinicio de la ejecución restante en el periodo de activación.
-                datos->ejecucion_restante = EJECUCION_T2;
-
-                // Se marca como tarea activa.
-                datos->activa = true;
-
-                // Se libera el semáforo.
-                xSemaphoreGive(semaforo); // Se libera el semáforo.
-            }
-            
-
-            // Resultado temporal recibido por una tarea T3.x
-            bool resultado = false;
+            pendiente = pendiente || requiereRevision(&trabajos[i]);
+            aplazado = aplazado || trabajos[i].aplazado;
+        }
+        if (!pendiente) ulTaskNotifyTake(pdTRUE, aplazado ? RETARDO_ADMISION : portMAX_DELAY);
 
-            // Cantidad de resultados que son true o false, depende
-            // del valor mayoritario.
-            int recuento = 0;
+        // Trabajo nuevo, si hay sitio para él.
+        TickType_t activacion = xTaskGetTickCount();
+        if (hueco != NULL && xQueueReceive(cola_T1_T2, &hueco->descriptor, 0) == pdTRUE)
+        {
+            hueco->etapa = TRABAJO_ADMISION;
+            hueco->aplazado = false;
+        }
 
-            // Se crean o activan las tareas T3.x. Cada una recibe su copia del nombre del archivo.
-            for(int i = POS_TAREAS_SECUNDARIAS; i < TOTAL_TAREAS; i++)
-            {
-                if(datos_tareas[i].handle == NULL) // Cuando no se han creado aún las tareas.
-                {
-                    // Se establece el nombre para la tarea T3.x
-                    char nombre_tarea[CARACTERES_TAREA];
-                    snprintf(nombre_tarea, CARACTERES_TAREA, "T3.%d", i - POS_TAREAS_SECUNDARIAS + 1);
-
-                    if( xSemaphoreTake(semaforo, portMAX_DELAY) == pdTRUE )
-                    {
-                        // Creación de la tarea T3.x
-                        xTaskCreate( xT3Code, nombre_tarea, configMINIMAL_STACK_SIZE, &datos_tareas[i], PRIORIDAD_BASE, &datos_tareas[i].handle );
-                        
-                        // Se libera el semáforo.
-                        xSemaphoreGive(semaforo); 
-                    }
-                }
-
-                // Se envía una copia del nombre del archivo a la cola.
-                xQueueSend( cola_T2_T3x, nombre_archivo, portMAX_DELAY );
-            }
+        // Admisión de los trabajos recibidos, nuevos o aplazados. Se pide antes de
+        // activar T2, que es la candidata.
+        for(int i = 0; i < TRABAJOS_EN_CURSO; i++)
+            if (trabajos[i].etapa == TRABAJO_ADMISION) admitirTrabajo(&trabajos[i], datos, activacion);
+
+        // Solo se activa un trabajo de T2 si hay réplicas que lanzar o votaciones que
+        // revisar; un aviso sin nada que hacer no reinicia su plazo ni su presupuesto.
+        bool atender = false;
+        for(int i = 0; i < TRABAJOS_EN_CURSO; i++)
+            atender = atender || trabajos[i].etapa == TRABAJO_REPLICAS || requiereRevision(&trabajos[i]) ||
+                      (trabajos[i].etapa == TRABAJO_VOTACION && trabajos[i].aplazado);
+        if (!atender) continue;
+
+        // Si la política de sobrecoste omite esta activación, lo pendiente se atiende
+        // en el siguiente despertar.
+        if (!iniciarTrabajoLLF( datos, activacion, EJECUCION_T2 ))
+        {
+            ulTaskNotifyTake(pdTRUE, RETARDO_ADMISION);
+            continue;
+        }
 
-            // Se reciben los datos de cada T3.x.
-            for(int i = 0; i < TAREAS_SECUNDARIAS; i++)
-            {
-                // Espera a recibir los valores de T3.x
-                if( xQueueReceive(cola_T3x_T2, &resultado, portMAX_DELAY) == pdTRUE )
-                {
-                    // Se incrementa si el valor es verdadero.
-                    if(resultado) recuento++;
-                }
-            }
+        for(int i = 0; i < TRABAJOS_EN_CURSO; i++)
+        {
+            TrabajoConsenso *trabajo = &trabajos[i];
 
-            // Imprime el resultado final.
-            imprimirResultado(recuento);
+            // Reparto de los trabajos admitidos entre las réplicas T3.x.
+            if (trabajo->etapa == TRABAJO_REPLICAS)
+                iniciarConsenso(trabajo, datos_T3x);
 
-            // Elimina el archivo una vez procesados los datos.
-            if (remove(nombre_archivo) != 0)
-                perror("Error al eliminar el archivo");
-            
-            if( xSemaphoreTake(semaforo, portMAX_DELAY) == pdTRUE )
+            // Votaciones con cruces o con una ampliación aplazada: se decide y se
+            // libera el hueco de las que han terminado, o se lanzan más réplicas a
+            // las que aún no son seguras.
+            else if ((requiereRevision(trabajo) || (trabajo->etapa == TRABAJO_VOTACION && trabajo->aplazado)) &&
+                     revisarConsenso(trabajo, datos_T3x))
             {
-                // Se desactiva la tarea.
-                datos->activa = false;
-                // Reinicio de su prioridad.
-                vTaskPrioritySet(datos->handle, PRIORIDAD_BASE);
-                // Se libera el semáforo.
-                xSemaphoreGive(semaforo); 
+                trabajo->etapa = TRABAJO_LIBRE;
+                if (++consensos % CONSENSOS_INFORME == 0) imprimirEstadisticas();
             }
         }
+
+        // Se desactiva la tarea hasta el siguiente aviso.
+        finalizarTrabajoLLF( datos );
     }
 }
 
 /*-----------------------------------------------------------*/
 
 /*
- * Tarea:           Se activa al recibir el nombre de un archivo
- *                  y lo analiza contando si hay más de un número
+ * Tarea:           Se activa al recibir un buffer de muestras
+ *                  y analiza la parte que le asigna T2 (todo el
+ *                  buffer salvo en el análisis repartido) contando
+ *                  si hay más de un número
  *                  determinado de valores cuyos valores absolutos
  *                  superan un umbral. En caso afirmativo, el resultado
  *                  que pretende devolver es true, en caso contrario, es
@@ -527,97 +669,98 @@ static void xT2Code(void * pvParameters )
  *
  * Autor:           Juan Misael Sánchez Pacheco
  * Fecha:           16 de mayo de 2025
- * Versión:         1.0
+ * Versión:         2.2
  * Tipo de tarea:   Esporádica
  */
 static void xT3Code(void * pvParameters )
 {
     DatosTarea *datos = (DatosTarea *) pvParameters;
 
-    if( xSemaphoreTake(semaforo, portMAX_DELAY) == pdTRUE )
-    {
-        datos->plazo_ejecucion = PLAZO_T3x;
-        xSemaphoreGive(semaforo); // Se libera el semáforo.
-    }
-    
-    char nombre_archivo[TOTAL_CARACTERES] = {0};
+    // Generador propio de la réplica para simular el error, con un flujo
+    // distinto para cada T3.x.
+    GeneradorAleatorio generador;
+    sembrarAleatorio(&generador, semilla, calcularFlujoTarea(pcTaskGetName(NULL)));
+
+    PeticionAnalisis peticion;
 
     while(true)
     {
         // Es el inicio de la tarea.
-        if( xQueueReceive( cola_T2_T3x, nombre_archivo, portMAX_DELAY ) == pdTRUE)
+        if( xQueueReceive( cola_T2_T3x, &peticion, portMAX_DELAY ) == pdTRUE)
         {
-            if( xSemaphoreTake(semaforo, portMAX_DELAY) == pdTRUE )
+            // Activación de la tarea, que termina como tarde en el plazo de su trabajo:
+            // las réplicas de un trabajo antiguo tienen menos holgura que las de uno nuevo.
+            // Si la política de sobrecoste omite esta activación, la réplica no analiza
+            // ni vota: libera el buffer y responde como abandonada, para que T2 no
+            // espere un voto que no llegará.
+            bool omitida = !iniciarTrabajoConPlazoLLF( datos, xTaskGetTickCount(), peticion.ejecucion, peticion.plazo );
+
+            // Muestras compartidas y de solo lectura, que se analizan a medida que se
+            // publican: cada vez, todo lo publicado de la parte asignada. El recuento se
+            // corta en el primer bloque en el que se alcanza la cantidad mínima de
+            // positivos necesarios o en el que T2 ya ha decidido el consenso, en cuyo
+            // caso el análisis se abandona (ver analisis.c).
+            BufferMuestras *muestras = peticion.muestras;
+            int contador_positivos = 0, leidas = peticion.inicio, publicadas;
+            bool abandonada = omitida;
+            while (!omitida && contador_positivos < MIN_POSITIVOS && leidas < peticion.fin &&
+                   !(abandonada = atomic_load_explicit(&peticion.votacion->decidido, memory_order_acquire)) &&
+                   (publicadas = esperarMuestras(muestras, leidas)) > leidas)
             {
-                // Instante de activación de la tarea.
-                datos->instante_activacion = xTaskGetTickCount();
-
-                // Reinicio de la ejecución restante.
-                datos->ejecucion_restante = EJECUCION_T3x;
+                int hasta = publicadas < peticion.fin ? publicadas : peticion.fin;
 
-                // Activación de la tarea.
-                datos->activa = true;
-
-                // Se libera el semáforo.
-                xSemaphoreGive(semaforo); 
+                contador_positivos += contarSuperanUmbral(&muestras->valores[leidas], hasta - leidas,
+                                                          UMBRAL, MIN_POSITIVOS - contador_positivos,
+                                                          &peticion.votacion->decidido);
+                leidas = hasta;
             }
 
-            // Apertura del archivo en modo lectura.
-            FILE *archivo = fopen(nombre_archivo, "r");
-
-            // Verificar si se pudo abrir correctamente
-            if (archivo == NULL) 
-            { 
-                perror( "No se pudo abrir el archivo." ); 
-                if( xSemaphoreTake(semaforo, portMAX_DELAY) == pdTRUE )
-                {
-                    datos->activa = false; // Se marca como inactiva.
-                    xSemaphoreGive(semaforo); // Se libera el semáforo.
-                }
-                continue; 
-            }
+            // Si la espera terminó porque T2 canceló las muestras, la réplica también abandona.
+            abandonada = abandonada || atomic_load_explicit(&peticion.votacion->decidido, memory_order_acquire);
 
-            // Valor que se lee.
-            double valor = 0.0;
+            // Resultado que se devolverá. Si ya es seguro, el resto de las muestras
+            // no cambia nada: la suma de las partes también alcanzará el mínimo.
+            bool resultado = contador_positivos >= MIN_POSITIVOS;
+            if (resultado) cancelarMuestras(muestras);
 
-            // Cantidad de valores que superan el umbral.
-            int contador_positivos = 0;
+            // Fin de la lectura: la última réplica devuelve el buffer a la reserva.
+            liberarMuestras(muestras);
 
-            // Resultado que se devolverá.
-            bool resultado = false;
+            // Número aleatorio entre 0.0 y 1.0.
+            double probabilidad = generarUniforme(&generador);
 
-            // Hasta que no haya un resultado o se termine el archivo.
-            while (!resultado && fscanf(archivo, "%lf", &valor) == 1)
+            // Simulación del posible error con una probabilidad de 20%: la réplica
+            // devuelve el resultado contrario y un recuento coherente con él.
+            if(probabilidad > PROBABILIDAD_EXITO && !abandonada)
             {
-                // Valores que superan el umbral.
-                if(fabs(valor) > UMBRAL) contador_positivos++; 
-
-                // Corte para evitar seguir leyendo si se supera o iguala la 
-                // cantidad mínima de positivos necesarios.
-                resultado = contador_positivos >= MIN_POSITIVOS; 
+                resultado = !resultado;
+                contador_positivos = resultado ? MIN_POSITIVOS : 0;
             }
 
-            // Número aleatorio entre 0.0 y 1.0.
-            double probabilidad = (double)rand() / (double)(RAND_MAX);
-
-            // Simulación del posible error con una probabilidad de 20%.
-            if(probabilidad > PROBABILIDAD_EXITO) resultado = !resultado;
+            // Envío del resultado a T2: el recuento, la tarea que lo emite, para su
+            // fiabilidad, y el bit de la réplica en la máscara de su respuesta. Tras contar la respuesta, la votación puede dejar de
+            // existir, así que antes se toma lo que hace falta de ella.
+            Votacion *votacion = peticion.votacion;
+            unsigned bit = 1U << peticion.replica;
+            int mayoria = votacion->mayoria, replicas = votacion->replicas;
 
-            // Envío del resultado a T2.
-            xQueueSend( cola_T3x_T2, &resultado, portMAX_DELAY );
+            votacion->recuentos[peticion.replica] = contador_positivos;
+            votacion->tareas[peticion.replica] = datos;
+            atomic_uint *mascara = abandonada ? &votacion->abandonadas : resultado ? &votacion->si : &votacion->no;
+            int votos = __builtin_popcount(atomic_fetch_or(mascara, bit) | bit);
+            bool ultima = atomic_fetch_add(&votacion->respuestas, 1) + 1 == replicas;
 
-            // Cierre del archivo.
-            fclose(archivo);
+            // Solo se despierta a T2 en los cruces: el voto que da la mayoría y la última respuesta.
+            if (ultima || (!abandonada && votos == mayoria)) xTaskNotifyGive( peticion.coordinadora );
 
-            if( xSemaphoreTake(semaforo, portMAX_DELAY) == pdTRUE )
+            if (!omitida && (BaseType_t) (int32_t) (xTaskGetTickCount() - peticion.plazo) > 0)
             {
-                // Se marca como inactiva.
-                datos->activa = false; 
-                // Reinicio de su prioridad.
-                vTaskPrioritySet(datos->handle, PRIORIDAD_BASE);
-                // Se libera el semáforo.
-                xSemaphoreGive(semaforo);
+                atomic_fetch_add(&respuestas_fuera_de_plazo, 1);
+                console_print("Trabajo %lu: %s ha respondido fuera de plazo\n", (unsigned long) peticion.trabajo, pcTaskGetName(NULL));
             }
+
+            // Se marca como inactiva, si llegó a activarse.
+            if (!omitida) finalizarTrabajoLLF( datos );
         }
     }
 }
@@ -631,56 +774,34 @@ static void xT3Code(void * pvParameters )
  *
  * Autor:           Juan Misael Sánchez Pacheco
  * Fecha:           16 de mayo de 2025
- * Versión:         1.0
+ * Versión:         1.3
  * Tipo de tarea:   Periódica
  */
 static void xT4Code(void * pvParameters )
 {
     DatosTarea *datos = (DatosTarea *) pvParameters;
-    TickType_t siguiente_activacion = 0; 
-
-    if( xSemaphoreTake(semaforo, portMAX_DELAY) == pdTRUE )
-    {
-        datos->plazo_ejecucion = PLAZO_T4;
-        datos->instante_activacion = xTaskGetTickCount();
-        siguiente_activacion = datos->instante_activacion; // Inicialización.
-        xSemaphoreGive(semaforo); // Se libera el semáforo.
-    }
-    
+    TickType_t siguiente_activacion = xTaskGetTickCount(); 
     
     while(true)
     { 
-        // Se toma el semáforo.
-        if( xSemaphoreTake(semaforo, portMAX_DELAY) == pdTRUE )
+        // Se marca T4 como activa con el instante de activación del periodo.
+        // Si la política de sobrecoste omite esta activación se espera a la siguiente.
+        if (!iniciarTrabajoLLF( datos, siguiente_activacion, EJECUCION_T4 ))
         {
-            // Se actualiza el instante de activación.
-            datos->instante_activacion = siguiente_activacion;
-
-            // Reinicio de la ejecución restante en el periodo de activación.
-            datos->ejecucion_restante = EJECUCION_T4;
-
-            // Se marca T4 como activa.   
-            datos->activa = true;
-
-            // Se libera el semáforo.
-            xSemaphoreGive(semaforo); 
+            esperarActivacionLLF( datos, &siguiente_activacion, PERIODO_T4 );
+            continue;
         }
 
-        // Consumo de CPU según el tiempo de ejecución máximo previsto.
-        while(xTaskGetTickCount() - siguiente_activacion < EJECUCION_T4);
+        // Consumo de CPU según el tiempo de ejecución máximo previsto más el exceso
+        // inyectado, salvo que el LLF aborte el trabajo por un sobrecoste o un plazo vencido.
+        while(xTaskGetTickCount() - siguiente_activacion < EJECUCION_T4 + pdMS_TO_TICKS( EXCESO_T4 ) &&
+              !trabajoAbortadoLLF( datos ));
 
-        if( xSemaphoreTake(semaforo, portMAX_DELAY) == pdTRUE )
-        {
-            // Se marca como desactivada.
-            datos->activa = false;
-            // Reinicio de su prioridad.
-            vTaskPrioritySet(datos->handle, PRIORIDAD_BASE);
-            // Se libera el semáforo.
-            xSemaphoreGive(semaforo); 
-        }
+        // Se marca como desactivada.
+        finalizarTrabajoLLF( datos );
         
         // Periodo de activación.
-        vTaskDelayUntil( &siguiente_activacion, PERIODO_T4 );
+        esperarActivacionLLF( datos, &siguiente_activacion, PERIODO_T4 );
     }
 }
 
@@ -693,138 +814,566 @@ static void xT4Code(void * pvParameters )
 
 
 /*
- * Función:     Calcula la holgura para una tarea en un instante de tiempo.  
+ * Función:         Calcula el flujo del generador de una tarea a partir
+ *                  de su nombre (FNV-1a).
+ *
+ * Autor:           Juan Misael Sánchez Pacheco
+ * Fecha:           17 de octubre de 2026
+ * Versión:         1.0
+ * Observaciones:   Se activa el bit alto para que no coincida con los
+ *                  flujos de los trabajos de T1.
+ */
+static uint64_t calcularFlujoTarea(const char *nombre)
+{
+    uint64_t flujo = 0xCBF29CE484222325ULL;
+
+    for ( ; *nombre != '\0'; nombre++)
+        flujo = (flujo ^ (unsigned char) *nombre) * 0x100000001B3ULL;
+
+    return flujo | (1ULL << 63);
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:         Envía un trabajo a T2 y la avisa. Si la cola está
+ *                  llena, aplica la política de saturación.
+ *
+ * Autor:           Juan Misael Sánchez Pacheco
+ * Fecha:           17 de octubre de 2026
+ * Versión:         1.0
+ * Observaciones:   Salvo con SATURACION_BLOQUEAR, T1 nunca espera a T2,
+ *                  así que un retraso de T2 no le hace perder su plazo.
+ *                  T1 es la única tarea que añade trabajos a la cola: en
+ *                  cuanto saca uno, el nuevo cabe.
+ */
+static void enviarTrabajo(const DescriptorTrabajo *descriptor)
+{
+    DescriptorTrabajo antiguo;
+
+    switch (POLITICA_SATURACION)
+    {
+        case SATURACION_BLOQUEAR:
+            xQueueSend( cola_T1_T2, descriptor, portMAX_DELAY );
+            break;
+
+        case SATURACION_DESCARTAR_ANTIGUO:
+            while (xQueueSend( cola_T1_T2, descriptor, 0 ) != pdTRUE)
+            {
+                if (xQueueReceive( cola_T1_T2, &antiguo, 0 ) != pdTRUE) continue;
+                descartarTrabajo(&antiguo);
+                atomic_fetch_add(&saturacion.descartados_antiguos, 1);
+            }
+            break;
+
+        case SATURACION_FUSIONAR:
+            if (xQueueSend( cola_T1_T2, descriptor, 0 ) == pdTRUE) break;
+
+            // El trabajo nuevo ocupa el lugar de todos los pendientes.
+            while (xQueueReceive( cola_T1_T2, &antiguo, 0 ) == pdTRUE)
+            {
+                descartarTrabajo(&antiguo);
+                atomic_fetch_add(&saturacion.fusionados, 1);
+            }
+            xQueueSend( cola_T1_T2, descriptor, 0 );
+            break;
+
+        default: // SATURACION_DESCARTAR_NUEVO y SATURACION_DEGRADAR.
+            if (xQueueSend( cola_T1_T2, descriptor, 0 ) == pdTRUE) break;
+
+            descartarTrabajo(descriptor);
+            atomic_fetch_add(&saturacion.descartados_nuevos, 1);
+            return;
+    }
+
+    xTaskNotifyGive( datos_T2->handle );
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:     Descarta un trabajo que no ha llegado a T2: cancela la
+ *              generación de sus muestras, si sigue en marcha, y libera
+ *              la referencia de T2 a su buffer.
+ *
  * Autor:       Juan Misael Sánchez Pacheco
- * Fecha:       16 de mayo de 2025
+ * Fecha:       17 de octubre de 2026
  * Versión:     1.0
  */
-static int calcularHolgura(DatosTarea tarea, TickType_t t_actual)
+static void descartarTrabajo(const DescriptorTrabajo *descriptor)
 {
-    return tarea.instante_activacion + tarea.plazo_ejecucion - t_actual - tarea.ejecucion_restante;
+    cancelarMuestras(descriptor->muestras);
+    liberarMuestras(descriptor->muestras);
 }
 
 /*-----------------------------------------------------------*/
 
 /*
- * Función:     Recalcula las prioridades de cada tarea según
- *              la holgura actual.
+ * Función:         Prepara la votación de un trabajo admitido y envía a
+ *                  cada réplica T3.x admitida su parte de las muestras.
+ *                  Con la votación ponderada solo se lanzan las réplicas
+ *                  justas para alcanzar la confianza objetivo si coinciden.
+ *
+ * Autor:           Juan Misael Sánchez Pacheco
+ * Fecha:           17 de octubre de 2026
+ * Versión:         1.2
+ * Observaciones:   Deja el trabajo en TRABAJO_VOTACION si se han lanzado
+ *                  las réplicas, aplazado si ahora no cabe ninguna o en
+ *                  TRABAJO_LIBRE, con su buffer ya liberado, si no sigue
+ *                  adelante. Un trabajo aplazado que pierde su plazo se
+ *                  descarta.
+ */
+static void iniciarConsenso(TrabajoConsenso *trabajo, DatosTarea **datos_T3x)
+{
+    BufferMuestras *muestras = trabajo->descriptor.muestras;
+
+#if !MUESTRAS_EN_FRAGMENTOS
+    // Las muestras del archivo, si lo hay, se cargan una sola vez para todas las
+    // réplicas, en el primer intento.
+    if (!trabajo->aplazado && !cargarMuestras(muestras))
+    {
+        perror("No se pudo cargar el archivo de muestras");
+        liberarMuestras(muestras);
+        trabajo->etapa = TRABAJO_LIBRE;
+        return;
+    }
+#endif
+
+    // Se crean las tareas T3.x que aún no existen, bloqueadas hasta recibir un buffer.
+    for(int i = 0; i < TAREAS_SECUNDARIAS; i++)
+    {
+        if(datos_T3x[i] == NULL) // Cuando no se han creado aún las tareas.
+        {
+            // Se establece el nombre para la tarea T3.x
+            char nombre_tarea[CARACTERES_TAREA];
+            snprintf(nombre_tarea, CARACTERES_TAREA, "T3.%d", i + 1);
+
+            // Creación y registro de la tarea T3.x
+            datos_T3x[i] = crearTareaLLF( xT3Code, nombre_tarea, PLAZO_T3x, PERIODO_T1 );
+        }
+    }
+
+    // Se activan tantas réplicas como admite el control de admisión. Si ahora no
+    // cabe ninguna, se reintenta en el siguiente despertar de T2 mientras el
+    // trabajo pueda cumplir su plazo.
+    int replicas = 0;
+    ResultadoAdmision admision = admitirReplicas(datos_T3x, &replicas);
+    if (admision == ADMISION_APLAZADA && trabajo->aplazado &&
+        (BaseType_t) (int32_t) (trabajo->descriptor.plazo - xTaskGetTickCount()) <= 0)
+        admision = ADMISION_RECHAZADA;
+
+    trabajo->aplazado = admision == ADMISION_APLAZADA;
+    if (trabajo->aplazado) return;
+
+    if (admision == ADMISION_RECHAZADA)
+    {
+        console_print("Control de admisión: réplicas del trabajo %lu rechazadas\n", (unsigned long) trabajo->descriptor.id);
+        cancelarMuestras(muestras);
+        liberarMuestras(muestras);
+        trabajo->etapa = TRABAJO_LIBRE;
+        return;
+    }
+
+    if (replicas < TAREAS_SECUNDARIAS)
+        console_print("Control de admisión: %d de %d réplicas T3.x admitidas\n", replicas, TAREAS_SECUNDARIAS);
+
+    // Con SATURACION_DEGRADAR, mientras haya trabajos esperando se usan menos
+    // réplicas para ponerse al día.
+    if (POLITICA_SATURACION == SATURACION_DEGRADAR && replicas > REPLICAS_DEGRADADAS &&
+        uxQueueMessagesWaiting(cola_T1_T2) > 0)
+    {
+        replicas = REPLICAS_DEGRADADAS;
+        atomic_fetch_add(&saturacion.degradados, 1);
+    }
+
+#if VOTACION_PONDERADA
+    // Si las primeras réplicas discrepan, T2 lanza más al revisar la votación.
+    int necesarias = calcularReplicasNecesarias(0);
+    if (replicas > necesarias) replicas = necesarias;
+#endif
+
+    // Las muestras se reparten en tantas partes como grupos completos de
+    // REPLICAS_POR_PARTE réplicas se han admitido. Las réplicas sobrantes
+    // refuerzan las primeras partes.
+    int partes = replicas / REPLICAS_POR_PARTE > 0 ? replicas / REPLICAS_POR_PARTE : 1;
+    trabajo->partes = partes;
+    trabajo->decidido = false;
+
+    // Votación del trabajo. Con una sola parte se decide en cuanto un valor tiene
+    // la mayoría absoluta; en el reparto y en la votación ponderada hacen falta
+    // todas las respuestas.
+    Votacion *votacion = &trabajo->votacion;
+    votacion->replicas = replicas;
+    votacion->mayoria = partes == 1 && !VOTACION_PONDERADA ? replicas / 2 + 1 : replicas + 1;
+    atomic_init(&votacion->si, 0);
+    atomic_init(&votacion->no, 0);
+    atomic_init(&votacion->abandonadas, 0);
+    atomic_init(&votacion->respuestas, 0);
+    atomic_init(&votacion->decidido, false);
+
+    enviarPeticiones(trabajo, 0, replicas);
+    trabajo->etapa = TRABAJO_VOTACION;
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:     Envía a las réplicas [desde, hasta) de un trabajo su
+ *              parte de las muestras.
  *
  * Autor:       Juan Misael Sánchez Pacheco
- * Fecha:       16 de mayo de 2025
+ * Fecha:       17 de octubre de 2026
  * Versión:     1.0
  */
-static void recalcularPrioridades(void)
+static void enviarPeticiones(TrabajoConsenso *trabajo, int desde, int hasta)
 {
-    UBaseType_t prioridad = PRIORIDAD_CONTROLADOR - 1; // Prioridad máxima posible es una menor que la del LLF.
-    bool asignada[TOTAL_TAREAS] = {false}; // Marca las tareas cuya prioridad ya ha sido recalculada.
-
-    // Asignación de prioridades según la holgura. Si se incrementara el número de tareas habría
-    // que buscar una mejor forma de recalcular prioridades, pero para esta práctica es suficiente
-    // y es una implementación sencilla en la que se busca la tarea con menor prioridad en cada iteración
-    // y se descarta la última encontrada, porque ya fue actualizada.
-    for (int i = 0; i < TOTAL_TAREAS; i++) 
+    BufferMuestras *muestras = trabajo->descriptor.muestras;
+    int partes = trabajo->partes;
+
+    // Cada réplica recibe una referencia al mismo buffer, que lee sin copiarlo,
+    // y la parte que debe analizar. Su ejecución prevista es la de su parte.
+    compartirMuestras(muestras, hasta - desde);
+    for(int i = desde; i < hasta; i++)
     {
-        int indice_menor = -1; // Índice de la tarea menor.
-        TickType_t holgura_menor = portMAX_DELAY; // Menor holgura encontrada.
+        PeticionAnalisis peticion = {
+            .trabajo = trabajo->descriptor.id,
+            .plazo = trabajo->descriptor.plazo,
+            .muestras = muestras,
+            .parte = i % partes,
+            .inicio = (i % partes) * NUMEROS_DECIMALES / partes,
+            .fin = (i % partes + 1) * NUMEROS_DECIMALES / partes,
+            .ejecucion = (EJECUCION_T3x + partes - 1) / partes,
+            .replica = i,
+            .votacion = &trabajo->votacion,
+            .coordinadora = datos_T2->handle
+        };
+        xQueueSend( cola_T2_T3x, &peticion, portMAX_DELAY );
+    }
+}
 
-        // Obtención de la tarea activa y cuya prioridad no se ha asignado que
-        // tiene la menor holgura.
-        for (int j = 0; j < TOTAL_TAREAS; j++) 
-        {
-            // Se omiten las tareas inactivas, ya asignadas o que ya se han completado.
-            if (!datos_tareas[j].activa || asignada[j] || datos_tareas[j].ejecucion_restante <= 0) continue;
+/*-----------------------------------------------------------*/
 
-            if (datos_tareas[j].holgura < holgura_menor) 
-            {
-                holgura_menor = datos_tareas[j].holgura; // Actualización de menor holgura encontrada.
-                indice_menor = j; // Índice de la tarea con menor holgura encontrada.
-            }
+/*
+ * Función:         Revisa la votación de un trabajo en curso: imprime el
+ *                  consenso en cuanto es seguro y, cuando han respondido
+ *                  todas las réplicas, cierra el trabajo o, en la
+ *                  votación ponderada, lanza más réplicas si aún no es
+ *                  seguro.
+ *
+ * Autor:           Juan Misael Sánchez Pacheco
+ * Fecha:           17 de octubre de 2026
+ * Versión:         1.2
+ * Observaciones:   Devuelve true si el trabajo ha terminado y su hueco
+ *                  queda libre. Hasta entonces T2 conserva la referencia
+ *                  del buffer, por si tiene que cancelar la generación o
+ *                  compartirlo con nuevas réplicas.
+ */
+static bool revisarConsenso(TrabajoConsenso *trabajo, DatosTarea **datos_T3x)
+{
+    Votacion *votacion = &trabajo->votacion;
+
+    // Una ampliación aplazada se vuelve a intentar (ver decidirVotacionPonderada).
+    trabajo->aplazado = false;
+
+    int recuento = __builtin_popcount(atomic_load(&votacion->si));
+    int en_contra = __builtin_popcount(atomic_load(&votacion->no));
+
+    if (!trabajo->decidido && (recuento >= votacion->mayoria || en_contra >= votacion->mayoria))
+    {
+        // Las réplicas pendientes ya no pueden cambiar el resultado: se
+        // imprime y se les pide que lo dejen. Si las muestras aún se
+        // están generando, T1 también para.
+        trabajo->decidido = true;
+        atomic_store_explicit(&votacion->decidido, true, memory_order_release);
+        cancelarMuestras(trabajo->descriptor.muestras);
+        imprimirResultado(&trabajo->descriptor, recuento, en_contra, votacion->replicas);
+    }
+
+    // Hasta que respondan todas las réplicas, también las que abandonan, la
+    // votación no se puede reutilizar.
+    if (atomic_load(&votacion->respuestas) < votacion->replicas) return false;
+
+    // En la votación ponderada, si los votos aún no dan la confianza objetivo, el
+    // trabajo sigue con más réplicas.
+    if (VOTACION_PONDERADA && !decidirVotacionPonderada(trabajo, datos_T3x)) return false;
+
+    // Ya no se lee el buffer: lo recicla la última réplica que lo libera.
+    liberarMuestras(trabajo->descriptor.muestras);
+
+    // Imprime el resultado final si no se ha decidido antes: la votación de las
+    // réplicas si todas han analizado todas las muestras o, si no, la suma de los
+    // recuentos de las partes. En cada parte se toma la mediana de sus réplicas,
+    // que descarta los recuentos erróneos mientras sean minoría.
+    if (trabajo->partes == 1)
+    {
+        if (!trabajo->decidido) imprimirResultado(&trabajo->descriptor, recuento, en_contra, votacion->replicas);
+    }
+    else
+    {
+        int positivos = 0;
+        for(int i = 0; i < trabajo->partes; i++)
+        {
+            // Recuentos de las réplicas de la parte (i, i + partes, ...).
+            int recuentos[TAREAS_SECUNDARIAS], total = 0;
+            for(int j = i; j < votacion->replicas; j += trabajo->partes) recuentos[total++] = votacion->recuentos[j];
+            positivos += calcularMediana(recuentos, total);
         }
+        imprimirRecuento(&trabajo->descriptor, positivos, trabajo->partes, votacion->replicas);
+    }
+
+    return true;
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:         Decide una votación ponderada en la que han respondido
+ *                  todas las réplicas lanzadas, o lanza más si sus votos
+ *                  no alcanzan CONFIANZA_OBJETIVO.
+ *
+ * Autor:           Juan Misael Sánchez Pacheco
+ * Fecha:           17 de octubre de 2026
+ * Versión:         1.3
+ * Observaciones:   Cada voto pesa el logaritmo de las probabilidades
+ *                  de acierto de su T3.x, de modo que la suma de los
+ *                  pesos es la evidencia a favor de true y la confianza
+ *                  es 1 / (1 + e^-|evidencia|). Al decidir, la
+ *                  fiabilidad de cada T3.x se actualiza según coincida
+ *                  con el consenso. Devuelve false si se han lanzado
+ *                  más réplicas o si su admisión se ha aplazado.
+ */
+static bool decidirVotacionPonderada(TrabajoConsenso *trabajo, DatosTarea **datos_T3x)
+{
+    Votacion *votacion = &trabajo->votacion;
+    unsigned si = atomic_load(&votacion->si), no = atomic_load(&votacion->no);
+
+    // T3.x de cada réplica y evidencia a favor de true. Toda réplica responde
+    // desde una de las T3.x de datos_T3x (ver xT3Code), así que la búsqueda
+    // siempre la encuentra.
+    int tareas[TAREAS_SECUNDARIAS];
+    double evidencia = 0;
+    for (int i = 0; i < votacion->replicas; i++)
+    {
+        tareas[i] = 0;
+        while (tareas[i] < TAREAS_SECUNDARIAS - 1 && datos_T3x[tareas[i]] != votacion->tareas[i]) tareas[i]++;
+        configASSERT( datos_T3x[tareas[i]] == votacion->tareas[i] );
 
-        // Asignación de la nueva prioridad que será 
-        if (indice_menor > -1) 
+        if (si & (1U << i)) evidencia += calcularPesoVoto(tareas[i]);
+        else if (no & (1U << i)) evidencia -= calcularPesoVoto(tareas[i]);
+    }
+
+    // Réplicas que alcanzarían la confianza si coincidieran con el valor que va
+    // ganando, dentro de las que quedan y de las que admite el control de admisión.
+    // Si ahora no cabe ninguna, se reintenta en el siguiente despertar de T2 mientras
+    // el trabajo esté en plazo; después se decide con lo que hay.
+    int adicionales = calcularReplicasNecesarias(fabs(evidencia));
+    if (adicionales > TAREAS_SECUNDARIAS - votacion->replicas)
+        adicionales = TAREAS_SECUNDARIAS - votacion->replicas;
+    if ((BaseType_t) (int32_t) (trabajo->descriptor.plazo - xTaskGetTickCount()) <= 0)
+        adicionales = 0;
+    if (adicionales > 0)
+    {
+        int admitidas = 0;
+        if (admitirReplicas(datos_T3x, &admitidas) == ADMISION_APLAZADA)
         {
-            // Tras establecer la nueva prioridad de decrementa la prioridad
-            // para la siguiente tarea que tendrá una prioridad menor a la actual.
-            vTaskPrioritySet(datos_tareas[indice_menor].handle, prioridad--);
-            asignada[indice_menor] = true; // Se marca como asignada para no considerarla más.
+            trabajo->aplazado = true;
+            return false;
         }
+        if (adicionales > admitidas) adicionales = admitidas;
     }
+
+    // Las réplicas anteriores ya han respondido, así que la votación se puede
+    // ampliar: las nuevas ocupan los bits siguientes.
+    if (adicionales > 0)
+    {
+        int desde = votacion->replicas;
+        votacion->replicas += adicionales;
+        votacion->mayoria = votacion->replicas + 1;
+        replicacion.escaladas++;
+        enviarPeticiones(trabajo, desde, votacion->replicas);
+        return false;
+    }
+
+    // Decisión con la confianza alcanzada, aunque no llegue a la objetivo si ya
+    // no se pueden lanzar más réplicas. El empate se resuelve a false.
+    bool resultado = evidencia > 0;
+    unsigned ganadores = resultado ? si : no;
+    for (int i = 0; i < votacion->replicas; i++)
+    {
+        if (!((si | no) & (1U << i))) continue;
+
+        fiabilidad[tareas[i]].votos++;
+        if (ganadores & (1U << i)) fiabilidad[tareas[i]].acuerdos++;
+    }
+
+    replicacion.trabajos++;
+    replicacion.replicas += votacion->replicas;
+
+    // Si las muestras aún se están generando, T1 para.
+    trabajo->decidido = true;
+    cancelarMuestras(trabajo->descriptor.muestras);
+    imprimirResultadoPonderado(&trabajo->descriptor, resultado, 1 / (1 + exp(-fabs(evidencia))),
+                               __builtin_popcount(ganadores), votacion->replicas);
+
+    return true;
 }
 
 /*-----------------------------------------------------------*/
 
 /*
- * Función:     Genera un nombre aleatorio para un fichero
- *              con extensión .txt y contenido en un directorio /f.
- * Autor:       Juan Misael Sánchez Pacheco
- * Fecha:       16 de mayo de 2025
- * Versión:     1.0
+ * Función:         Devuelve la probabilidad de acierto estimada de una
+ *                  T3.x: la proporción de sus votos que coincidieron
+ *                  con el consenso.
+ *
+ * Autor:           Juan Misael Sánchez Pacheco
+ * Fecha:           17 de octubre de 2026
+ * Versión:         1.0
+ * Observaciones:   Parte de VOTOS_FIABILIDAD_PREVIA votos con
+ *                  PROBABILIDAD_EXITO y se limita a [0.5, FIABILIDAD_MAXIMA].
  */
-static void generarNombreAleatorio(char *nombre) 
+static double calcularFiabilidad(int tarea)
 {
-    // Rango de 6 caracteres de 'a' a 'z'.
-    int i = 0;
-
-    // Directorio
-    nombre[i++] = 'f';
-    nombre[i++] = '/';
-
-    // Generación de los caracteres aleatorios.
-    for( ; i < TOTAL_CARACTERES - 5; i++)
-        nombre[i] = (char)(rand() % 26 + 'a');
-
-    // Extensión .txt
-    nombre[i++] = '.';
-    nombre[i++] = 't';
-    nombre[i++] = 'x';
-    nombre[i++] = 't';
-    nombre[i] = '\0';
+    double acierto = (fiabilidad[tarea].acuerdos + VOTOS_FIABILIDAD_PREVIA * PROBABILIDAD_EXITO) /
+                     (fiabilidad[tarea].votos + VOTOS_FIABILIDAD_PREVIA);
+
+    if (acierto > FIABILIDAD_MAXIMA) return FIABILIDAD_MAXIMA;
+    return acierto < 0.5 ? 0.5 : acierto;
 }
 
 /*-----------------------------------------------------------*/
 
 /*
- * Función:         Utilizando el método de transformación de Box-Muller se genera 
- *                  un valor decimal aleatorio que será miembro de una distribución
- *                  normal con media cero y desviación estándar unitaria.
+ * Función:         Devuelve el peso del voto de una T3.x: el logaritmo
+ *                  de sus probabilidades de acierto frente a error.
  *
- * Autor:           Matt Ingenthron y Juan Misael Sánchez Pacheco.
- * Fecha:           16 de mayo de 2025
+ * Autor:           Juan Misael Sánchez Pacheco
+ * Fecha:           17 de octubre de 2026
  * Versión:         1.0
- * Observaciones:   Las fuentes de las que se extrae la información para la
- *                  comprensión del problema y el algoritmo ya elaborado son
- *                  las siguientes:
- *                      - https://es.khanacademy.org/computing/computer-programming/programming-natural-simulations/programming-randomness/a/normal-distribution-of-random-numbers
- *                      - https://github.com/ingenthr/memcachetest/blob/master/boxmuller.c
+ * Observaciones:   Una T3.x que no acierta más que el azar pesa 0.
  */
-static double generarAleatorioNormal(void)
-{				        
-	double x1, x2, w, y1;
-	static double y2;
-	static bool usar_ultimo = false;
-
-	if (usar_ultimo)		        
-	{
-		y1 = y2;
-		usar_ultimo = false;
-	}
-	else
-	{
-		do 
-        {
-			x1 = 2.0 * ((double)rand() + 1.0) / ((double)RAND_MAX + 2.0) - 1.0;
-			x2 = 2.0 * ((double)rand() + 1.0) / ((double)RAND_MAX + 2.0) - 1.0;
-			w = x1 * x1 + x2 * x2;
-		} 
-        while ( w >= 1.0 );
-
-		w = sqrt( (-2.0 * log( w ) ) / w );
-		y1 = x1 * w;
-		y2 = x2 * w;
-		usar_ultimo = true;
-	}
-	return MEDIA + y1 * DESVIACION;
+static double calcularPesoVoto(int tarea)
+{
+    double acierto = calcularFiabilidad(tarea);
+
+    return log(acierto / (1 - acierto));
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:         Calcula cuántas réplicas más harían falta para
+ *                  alcanzar CONFIANZA_OBJETIVO con la evidencia dada si
+ *                  todas votaran lo mismo que la mayoría ponderada.
+ *
+ * Autor:           Juan Misael Sánchez Pacheco
+ * Fecha:           17 de octubre de 2026
+ * Versión:         1.0
+ * Observaciones:   Como no se sabe qué T3.x tomará cada petición, cada
+ *                  réplica cuenta con el peso medio. Devuelve 0 si ya se
+ *                  ha alcanzado y como mucho TAREAS_SECUNDARIAS. Con 80%
+ *                  de acierto, sin evidencia, son 3 réplicas.
+ */
+static int calcularReplicasNecesarias(double evidencia)
+{
+    const double objetivo = log(CONFIANZA_OBJETIVO / (1 - CONFIANZA_OBJETIVO));
+    if (evidencia >= objetivo) return 0;
+
+    double peso = 0;
+    for (int i = 0; i < TAREAS_SECUNDARIAS; i++) peso += calcularPesoVoto(i);
+    peso /= TAREAS_SECUNDARIAS;
+
+    double replicas = ceil((objetivo - evidencia) / peso);
+    return peso > 0 && replicas < TAREAS_SECUNDARIAS ? (int) replicas : TAREAS_SECUNDARIAS;
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:         Pide la admisión del trabajo de T2 para un trabajo
+ *                  recibido de T1. Si se admite, el trabajo pasa a
+ *                  esperar sus réplicas; si se rechaza o ya no puede
+ *                  cumplir su plazo, se descarta.
+ *
+ * Autor:           Juan Misael Sánchez Pacheco
+ * Fecha:           17 de octubre de 2026
+ * Versión:         1.1
+ * Observaciones:   No espera: si la admisión se aplaza, el trabajo
+ *                  queda aplazado y T2 la vuelve a pedir en su siguiente
+ *                  despertar. El control de admisión lo rechaza cuando
+ *                  ya no le queda margen para seguir esperando.
+ */
+static void admitirTrabajo(TrabajoConsenso *trabajo, DatosTarea *datos, TickType_t activacion)
+{
+    ResultadoAdmision admision = ADMISION_RECHAZADA;
+
+    if ((BaseType_t) (int32_t) (trabajo->descriptor.plazo - activacion) > 0)
+        admision = comprobarAdmisionLLF(&datos, 1, activacion, EJECUCION_T2);
+
+    trabajo->aplazado = admision == ADMISION_APLAZADA;
+    if (admision == ADMISION_ADMITIDA) trabajo->etapa = TRABAJO_REPLICAS;
+    if (admision != ADMISION_RECHAZADA) return;
+
+    console_print("Control de admisión: trabajo %lu de T2 rechazado\n", (unsigned long) trabajo->descriptor.id);
+    cancelarMuestras(trabajo->descriptor.muestras); // T1 deja de generar el resto, si aún no ha terminado.
+    liberarMuestras(trabajo->descriptor.muestras);
+    trabajo->etapa = TRABAJO_LIBRE;
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:         Calcula cuántas réplicas T3.x se pueden activar ahora:
+ *                  la mayor cantidad que admite el control de admisión.
+ *
+ * Autor:           Juan Misael Sánchez Pacheco
+ * Fecha:           17 de octubre de 2026
+ * Versión:         1.1
+ * Observaciones:   No espera. Si se admite alguna réplica devuelve
+ *                  ADMISION_ADMITIDA y su cantidad; si no cabe ni una,
+ *                  la decisión sobre una sola réplica (aplazada o
+ *                  rechazada), con 0 réplicas.
+ */
+static ResultadoAdmision admitirReplicas(DatosTarea **datos_T3x, int *replicas)
+{
+    ResultadoAdmision admision = ADMISION_RECHAZADA;
+
+    // Solo se activan réplicas que se han podido crear.
+    int creadas = 0;
+    while (creadas < TAREAS_SECUNDARIAS && datos_T3x[creadas] != NULL) creadas++;
+
+    // Con menos réplicas la demanda es menor.
+    for (*replicas = creadas; *replicas > 0; (*replicas)--)
+    {
+        admision = comprobarAdmisionLLF(datos_T3x, *replicas, xTaskGetTickCount(), EJECUCION_T3x);
+        if (admision == ADMISION_ADMITIDA) break;
+    }
+
+    return admision;
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:         Indica si T2 tiene que revisar la votación de un
+ *                  trabajo: un valor ha alcanzado la mayoría y aún no
+ *                  se ha decidido, o ya han respondido todas las réplicas.
+ *
+ * Autor:           Juan Misael Sánchez Pacheco
+ * Fecha:           17 de octubre de 2026
+ * Versión:         1.0
+ * Observaciones:   Son los mismos cruces en los que las réplicas avisan
+ *                  a T2. Una votación con la ampliación aplazada espera
+ *                  al siguiente despertar.
+ */
+static bool requiereRevision(TrabajoConsenso *trabajo)
+{
+    Votacion *votacion = &trabajo->votacion;
+
+    if (trabajo->etapa != TRABAJO_VOTACION || trabajo->aplazado) return false;
+    if (atomic_load(&votacion->respuestas) >= votacion->replicas) return true;
+
+    return !trabajo->decidido && (__builtin_popcount(atomic_load(&votacion->si)) >= votacion->mayoria ||
+                                  __builtin_popcount(atomic_load(&votacion->no)) >= votacion->mayoria);
 }
 
 /*-----------------------------------------------------------*/
@@ -832,20 +1381,22 @@ static double generarAleatorioNormal(void)
 /*
  * Función:     Imprime los resultados según el recuento positivo
  *              de los resultados obtenidos por los T3.x en T2.
- *              El recuento que se hace en T2 es de los valores
- *              positivos (true).
+ *              Los recuentos son los de los valores positivos
+ *              (true) y negativos (false) recibidos hasta decidir,
+ *              entre las réplicas admitidas, con el trabajo y si
+ *              se ha pasado de su plazo.
  *
  * Autor:       Juan Misael Sánchez Pacheco
  * Fecha:       16 de mayo de 2025
- * Versión:     1.0
+ * Versión:     1.3
  */
-static void imprimirResultado(int recuento)
+static void imprimirResultado(const DescriptorTrabajo *trabajo, int recuento, int en_contra, int replicas)
 {
     // La información para el resultado la contiene el valor de recuento.
     bool resultado = false;
 
     // Punto medio para la cantidad de resultados. El valor es 4 para 9 tareas.
-    const int punto_medio = (int) ( TAREAS_SECUNDARIAS * 0.5f );
+    const int punto_medio = (int) ( replicas * 0.5f );
     
     // Mayoría es true.
     if(recuento > punto_medio) 
@@ -855,34 +1406,142 @@ static void imprimirResultado(int recuento)
     // Mayoría es false.
     else
     {
-        recuento = TAREAS_SECUNDARIAS - recuento; // Se invierte el recuento.
+        recuento = en_contra; // Se toma el recuento contrario.
         resultado = false;
     }
     
-    console_print("Consenso alcanzado entre %d de %d tareas. Valor de consenso %s\n", 
-        recuento, TAREAS_SECUNDARIAS, resultado ? "true" : "false");
+    console_print("Trabajo %lu: consenso alcanzado entre %d de %d tareas. Valor de consenso %s%s\n", 
+        (unsigned long) trabajo->id, recuento, replicas, resultado ? "true" : "false",
+        (BaseType_t) (int32_t) (xTaskGetTickCount() - trabajo->plazo) > 0 ? " (fuera de plazo)" : "");
     
 }
 
 /*-----------------------------------------------------------*/
 
 /*
- * Función:         Obtiene la última tarea que se estaba
- *                  ejecutando.
+ * Función:         Devuelve la mediana de los recuentos de las réplicas
+ *                  de una parte. Los ordena en el propio array.
  *
  * Autor:           Juan Misael Sánchez Pacheco
- * Fecha:           16 de mayo de 2025
+ * Fecha:           17 de octubre de 2026
  * Versión:         1.0
- * Observaciones:   Se extrae la forma de registrar la última
- *                  tarea ejecuta de la documentación de FreeRTOS:
- *                      - https://www.freertos.org/Documentation/02-Kernel/02-Kernel-features/09-RTOS-trace-feature
+ * Observaciones:   Con un número par de réplicas se toma el menor de los
+ *                  dos centrales. Sin réplicas devuelve 0.
  */
-static void actualizarTareaEjecutada(void *pxCurrentTCB)
+static int calcularMediana(int *recuentos, int total)
 {
-    // No actualiza cuando es el propio planificador LLF
-    if (pxCurrentTCB != tarea_LLF)
+    if (total == 0) return 0;
+
+    // Ordenación por inserción: como mucho hay TAREAS_SECUNDARIAS recuentos.
+    for (int i = 1; i < total; i++)
     {
-        // Se actualiza con la tarea que se está ejecutando.
-        tarea_ejecutada = (TaskHandle_t) pxCurrentTCB;
-    }  
+        int valor = recuentos[i], j = i;
+        for ( ; j > 0 && recuentos[j - 1] > valor; j--) recuentos[j] = recuentos[j - 1];
+        recuentos[j] = valor;
+    }
+
+    return recuentos[(total - 1) / 2];
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:     Imprime el resultado del análisis repartido: la suma
+ *              de los recuentos de las partes frente al mínimo,
+ *              con el trabajo y si se ha pasado de su plazo.
+ *
+ * Autor:       Juan Misael Sánchez Pacheco
+ * Fecha:       17 de octubre de 2026
+ * Versión:     1.1
+ */
+static void imprimirRecuento(const DescriptorTrabajo *trabajo, int positivos, int partes, int replicas)
+{
+    console_print("Trabajo %lu: recuento de %d partes entre %d tareas: %d%s positivos. Valor de consenso %s%s\n",
+        (unsigned long) trabajo->id, partes, replicas, positivos, positivos >= MIN_POSITIVOS ? " o más" : "",
+        positivos >= MIN_POSITIVOS ? "true" : "false",
+        (BaseType_t) (int32_t) (xTaskGetTickCount() - trabajo->plazo) > 0 ? " (fuera de plazo)" : "");
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:     Imprime el resultado de la votación ponderada: el valor
+ *              decidido, los votos a su favor entre las réplicas
+ *              lanzadas y la confianza alcanzada, con el trabajo y si
+ *              se ha pasado de su plazo.
+ *
+ * Autor:       Juan Misael Sánchez Pacheco
+ * Fecha:       17 de octubre de 2026
+ * Versión:     1.1
+ */
+static void imprimirResultadoPonderado(const DescriptorTrabajo *trabajo, bool resultado, double confianza,
+                                       int votos, int replicas)
+{
+    console_print("Trabajo %lu: consenso ponderado entre %d de %d tareas (confianza %.3f). Valor de consenso %s%s\n",
+        (unsigned long) trabajo->id, votos, replicas, confianza, resultado ? "true" : "false",
+        (BaseType_t) (int32_t) (xTaskGetTickCount() - trabajo->plazo) > 0 ? " (fuera de plazo)" : "");
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:     Imprime los contadores del planificador para comparar
+ *              las políticas con la carga real: cambios de contexto,
+ *              coste del controlador, plazos perdidos, inactividad,
+ *              trabajos descartados por saturación, respuestas tardías
+ *              de las réplicas y réplicas de la votación ponderada.
+ *
+ * Autor:       Juan Misael Sánchez Pacheco
+ * Fecha:       17 de octubre de 2026
+ * Versión:     1.7
+ */
+static void imprimirEstadisticas(void)
+{
+    EstadisticasLLF estadisticas;
+    obtenerEstadisticasLLF(&estadisticas);
+
+    console_print("Planificador %s: %u cambios de contexto, %u pasadas del controlador (%u us de CPU), "
+        "%u plazos perdidos, %u cambios evitados y %u plazos perdidos por el anti-thrashing\n",
+        obtenerNombrePolitica(), estadisticas.cambios_contexto, estadisticas.pasadas_controlador,
+        estadisticas.tiempo_controlador, estadisticas.plazos_perdidos,
+        estadisticas.cambios_evitados, estadisticas.perdidas_introducidas);
+    console_print("Control de admisión: %u trabajos admitidos, %u aplazamientos y %u rechazos\n",
+        estadisticas.trabajos_admitidos, estadisticas.trabajos_aplazados, estadisticas.trabajos_rechazados);
+    console_print("Sobrecostes: %u trabajos han agotado su presupuesto y %u activaciones se han omitido\n",
+        estadisticas.sobrecostes, estadisticas.activaciones_omitidas);
+    console_print("Inactividad: %u ms en reposo, %u despertares (%u anticipados), latencia media %u us y máxima %u us\n",
+        estadisticas.tiempo_inactivo / 1000, estadisticas.despertares + estadisticas.despertares_anticipados,
+        estadisticas.despertares_anticipados,
+        estadisticas.despertares > 0 ? estadisticas.latencia_despertar_total / estadisticas.despertares : 0,
+        estadisticas.latencia_despertar_maxima);
+    console_print("Saturación: %u trabajos antiguos y %u nuevos descartados, %u sin buffer libre, %u fusionados y %u degradados\n",
+        atomic_load(&saturacion.descartados_antiguos), atomic_load(&saturacion.descartados_nuevos),
+        atomic_load(&saturacion.sin_buffer), atomic_load(&saturacion.fusionados), atomic_load(&saturacion.degradados));
+    console_print("Réplicas: %u respuestas fuera del plazo de su trabajo\n", atomic_load(&respuestas_fuera_de_plazo));
+
+#if VOTACION_PONDERADA
+    double minima = 1, maxima = 0;
+    for (int i = 0; i < TAREAS_SECUNDARIAS; i++)
+    {
+        double acierto = calcularFiabilidad(i);
+        if (acierto < minima) minima = acierto;
+        if (acierto > maxima) maxima = acierto;
+    }
+    console_print("Replicación: %.1f réplicas por trabajo de media, %u ampliaciones, fiabilidad de las T3.x entre %.2f y %.2f\n",
+        replicacion.trabajos > 0 ? (double) replicacion.replicas / replicacion.trabajos : 0.0,
+        replicacion.escaladas, minima, maxima);
+#endif
+
+    // Detalle de las tareas con incidencias: T1, T2, T4 y las T3.x.
+    IncidenciasTarea incidencias[TAREAS_SECUNDARIAS + 3];
+    int total = obtenerIncidenciasLLF(incidencias, TAREAS_SECUNDARIAS + 3);
+    for (int i = 0; i < total; i++)
+    {
+        if (incidencias[i].plazos_perdidos == 0 && incidencias[i].sobrecostes == 0 &&
+            incidencias[i].activaciones_omitidas == 0) continue;
+
+        console_print("  %s: %u plazos perdidos, %u sobrecostes, %u activaciones omitidas\n",
+            incidencias[i].nombre, incidencias[i].plazos_perdidos, incidencias[i].sobrecostes,
+            incidencias[i].activaciones_omitidas);
+    }
 }
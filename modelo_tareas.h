@@ -0,0 +1,56 @@
+/*
+ * FreeRTOS V202112.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+#ifndef MODELO_TAREAS_H
+    #define MODELO_TAREAS_H
+
+    #include "FreeRTOS.h"
+
+/*-----------------------------------------------------------
+* Modelo temporal de las tareas de la aplicación. Lo usan las
+* tareas reales (main_base.c) y el simulador (simulador.c).
+*----------------------------------------------------------*/
+
+    // Periodos de las tareas (T) periódicas
+    #define PERIODO_T1  pdMS_TO_TICKS( 1000UL ) // 1000 ms.
+    #define PERIODO_T4  pdMS_TO_TICKS( 2000UL ) // 2000 ms.
+
+    // Plazos de ejecución para las tareas (D).
+    #define PLAZO_T1    pdMS_TO_TICKS( 300UL )  // 300 ms.
+    #define PLAZO_T2    pdMS_TO_TICKS( 1000UL ) // 1000 ms.
+    #define PLAZO_T3x   pdMS_TO_TICKS( 500UL )  // 500 ms.
+    #define PLAZO_T4    pdMS_TO_TICKS( 2000UL ) // 2000 ms.
+
+    // Tiempos de ejecución (C)
+    #define EJECUCION_T1    pdMS_TO_TICKS( 100UL )  // 100 ms.
+    #define EJECUCION_T2    pdMS_TO_TICKS( 100UL )  // 100 ms.
+    #define EJECUCION_T3x   pdMS_TO_TICKS( 50UL )   // 50 ms.
+    #define EJECUCION_T4    pdMS_TO_TICKS( 500UL  ) // 500 ms.
+
+    // Cantidad de tareas T3.x
+    #define TAREAS_SECUNDARIAS 9
+
+#endif /* MODELO_TAREAS_H */
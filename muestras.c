@@ -0,0 +1,549 @@
+/*
+ * FreeRTOS V202112.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+ /***************************************************************************************
+ * Módulo:              Reserva de buffers de muestras con recuento de referencias.     *
+ *                                                                                      *
+ *                      T1 rellena un buffer y lo pasa por las colas como una           *
+ *                      dirección; T2 y las T3.x lo leen en el sitio y el último        *
+ *                      que lo libera lo devuelve a la reserva. Sustituye al archivo    *
+ *                      que T1 escribía y cada T3.x volvía a leer.                      *
+ *                                                                                      *
+ *                      La reserva es estática y no usa semáforos: cada buffer lleva    *
+ *                      un contador atómico de referencias.                             *
+ *                                                                                      *
+ *                      Para auditoría, las muestras de cada trabajo se pueden          *
+ *                      guardar en un archivo de texto (formato original) o en uno      *
+ *                      binario con cabecera, que se proyecta con mmap. El archivo      *
+ *                      se carga una sola vez en el buffer y todos sus lectores         *
+ *                      analizan esa copia, que ya no cambia.                           *
+ *                                                                                      *
+ *                      Las muestras se publican por fragmentos: cada fragmento         *
+ *                      completo activa un bit del grupo de eventos del buffer y        *
+ *                      los lectores pueden analizarlo mientras se genera el            *
+ *                      siguiente. Un lector que ya tiene su resultado puede            *
+ *                      cancelar el resto de la producción.                             *
+ *                                                                                      *
+ * Autor:               Juan Misael Sánchez Pacheco                                     *
+ * Fecha:               17 de octubre de 2026                                           *
+ * Versión:             1.3                                                             *
+ ****************************************************************************************/
+
+
+
+
+/*-----------------------------------------------------------*/
+
+
+
+
+/* BIBLIOTECAS */
+
+/* Bibliotecas utilizadas */
+#include <stdio.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/* Local includes. */
+#include "muestras.h"
+
+
+
+
+/*-----------------------------------------------------------*/
+
+
+
+
+/* CONSTANTES. */
+
+// Tipo de las muestras del formato binario. Con float el archivo ocupa la
+// mitad a costa de la precisión; por defecto se guardan como double, sin pérdida.
+#ifndef MUESTRAS_BINARIAS_FLOAT
+    #define MUESTRAS_BINARIAS_FLOAT 0
+#endif
+
+#if MUESTRAS_BINARIAS_FLOAT
+    typedef float MuestraBinaria;
+#else
+    typedef double MuestraBinaria;
+#endif
+
+
+
+
+/*-----------------------------------------------------------*/
+
+
+
+
+/* VARIABLES Y DATOS. */
+
+// Reserva de buffers. Todos empiezan libres (sin referencias).
+static BufferMuestras buffers[TOTAL_BUFFERS_MUESTRAS];
+
+
+
+
+/*-----------------------------------------------------------*/
+
+
+
+
+// PROTOTIPOS DE FUNCIONES.
+
+static bool guardarTexto(const BufferMuestras *);
+static bool guardarBinario(const BufferMuestras *);
+static bool proyectarBinario(LectorMuestras *);
+
+
+
+
+/*-----------------------------------------------------------*/
+
+
+
+
+/*
+ * Función:         Reserva un buffer libre para rellenarlo. Quien lo
+ *                  reserva tiene su única referencia.
+ *
+ * Autor:           Juan Misael Sánchez Pacheco
+ * Fecha:           17 de octubre de 2026
+ * Versión:         1.2
+ * Observaciones:   Devuelve NULL si todos los buffers están en uso.
+ *                  La reserva se hace con una comparación e intercambio,
+ *                  así que dos tareas nunca obtienen el mismo buffer.
+ */
+BufferMuestras *reservarMuestras(void)
+{
+    for (int i = 0; i < TOTAL_BUFFERS_MUESTRAS; i++)
+    {
+        int libre = 0;
+        if (atomic_compare_exchange_strong_explicit(&buffers[i].referencias, &libre, 1,
+                                                    memory_order_acquire, memory_order_relaxed))
+        {
+            buffers[i].total = 0;
+            buffers[i].formato = FORMATO_MEMORIA;
+            buffers[i].archivo[0] = '\0';
+            atomic_store_explicit(&buffers[i].publicadas, 0, memory_order_relaxed);
+            atomic_store_explicit(&buffers[i].cancelado, false, memory_order_relaxed);
+
+            // El grupo de eventos se crea con el primer uso del buffer y se vacía en cada reserva.
+            if (buffers[i].fragmentos == NULL)
+                buffers[i].fragmentos = xEventGroupCreateStatic(&buffers[i].memoria_fragmentos);
+            else
+                xEventGroupClearBits(buffers[i].fragmentos, BITS_FRAGMENTOS);
+
+            return &buffers[i];
+        }
+    }
+
+    return NULL;
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:         Añade las referencias de los lectores a los que se va
+ *                  a pasar el buffer.
+ *
+ * Autor:           Juan Misael Sánchez Pacheco
+ * Fecha:           17 de octubre de 2026
+ * Versión:         1.0
+ * Observaciones:   Debe llamarse antes de enviar el buffer, mientras quien
+ *                  lo comparte aún tiene su referencia.
+ */
+void compartirMuestras(BufferMuestras *buffer, int lectores)
+{
+    atomic_fetch_add_explicit(&buffer->referencias, lectores, memory_order_relaxed);
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:         Libera una referencia al buffer. Con la última, el
+ *                  buffer vuelve a la reserva.
+ *
+ * Autor:           Juan Misael Sánchez Pacheco
+ * Fecha:           17 de octubre de 2026
+ * Versión:         1.0
+ * Observaciones:   La semántica release garantiza que las lecturas del
+ *                  buffer terminan antes de que otra tarea lo reserve.
+ */
+void liberarMuestras(BufferMuestras *buffer)
+{
+    atomic_fetch_sub_explicit(&buffer->referencias, 1, memory_order_release);
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:         Publica las muestras escritas hasta la posición
+ *                  indicada y despierta a los lectores que esperaban
+ *                  los fragmentos que se completan.
+ *
+ * Autor:           Juan Misael Sánchez Pacheco
+ * Fecha:           17 de octubre de 2026
+ * Versión:         1.0
+ * Observaciones:   Solo la llama quien rellena el buffer. Las muestras
+ *                  publicadas ya no se modifican.
+ */
+void publicarMuestras(BufferMuestras *buffer, int publicadas)
+{
+    int anteriores = atomic_exchange_explicit(&buffer->publicadas, publicadas, memory_order_release);
+
+    // Fragmentos completos antes y después de publicar.
+    EventBits_t bits = 0;
+    for (int i = anteriores / MUESTRAS_POR_FRAGMENTO; i < publicadas / MUESTRAS_POR_FRAGMENTO; i++)
+        bits |= (EventBits_t) 1 << i;
+
+    if (bits != 0) xEventGroupSetBits(buffer->fragmentos, bits);
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:         Cierra el buffer con las muestras publicadas: no se
+ *                  publicarán más y los lectores que esperaban terminan.
+ *
+ * Autor:           Juan Misael Sánchez Pacheco
+ * Fecha:           17 de octubre de 2026
+ * Versión:         1.0
+ * Observaciones:   Si se ha cancelado, el buffer se cierra con menos
+ *                  muestras de las previstas.
+ */
+void cerrarMuestras(BufferMuestras *buffer)
+{
+    buffer->total = atomic_load_explicit(&buffer->publicadas, memory_order_relaxed);
+    xEventGroupSetBits(buffer->fragmentos, BIT_CIERRE_MUESTRAS);
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:         Espera a que haya más muestras publicadas que las ya
+ *                  leídas o a que se cierre el buffer, y devuelve las
+ *                  muestras publicadas.
+ *
+ * Autor:           Juan Misael Sánchez Pacheco
+ * Fecha:           17 de octubre de 2026
+ * Versión:         1.0
+ * Observaciones:   Si devuelve las mismas muestras que ya se han leído,
+ *                  el buffer está cerrado y no queda nada por leer. Los
+ *                  bits no se borran al despertar, así que todos los
+ *                  lectores ven cada fragmento.
+ */
+int esperarMuestras(BufferMuestras *buffer, int leidas)
+{
+    int fragmento = leidas / MUESTRAS_POR_FRAGMENTO;
+    EventBits_t esperados = BIT_CIERRE_MUESTRAS;
+    if (fragmento < TOTAL_FRAGMENTOS) esperados |= (EventBits_t) 1 << fragmento;
+
+    xEventGroupWaitBits(buffer->fragmentos, esperados, pdFALSE, pdFALSE, portMAX_DELAY);
+
+    return atomic_load_explicit(&buffer->publicadas, memory_order_acquire);
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:         Indica a quien rellena el buffer que ya no hace
+ *                  falta publicar más muestras.
+ *
+ * Autor:           Juan Misael Sánchez Pacheco
+ * Fecha:           17 de octubre de 2026
+ * Versión:         1.0
+ * Observaciones:   Quien rellena el buffer lo comprueba entre fragmentos
+ *                  con muestrasCanceladas y lo cierra con lo publicado.
+ */
+void cancelarMuestras(BufferMuestras *buffer)
+{
+    atomic_store_explicit(&buffer->cancelado, true, memory_order_relaxed);
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:     Devuelve si algún lector ha cancelado el buffer.
+ *
+ * Autor:       Juan Misael Sánchez Pacheco
+ * Fecha:       17 de octubre de 2026
+ * Versión:     1.0
+ */
+bool muestrasCanceladas(BufferMuestras *buffer)
+{
+    return atomic_load_explicit(&buffer->cancelado, memory_order_relaxed);
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:         Guarda las muestras del buffer en un archivo con el
+ *                  formato indicado, con nombre según el trabajo, y lo
+ *                  anota en el buffer para que los lectores lo abran.
+ *
+ * Autor:           Juan Misael Sánchez Pacheco
+ * Fecha:           17 de octubre de 2026
+ * Versión:         1.0
+ * Observaciones:   Con FORMATO_MEMORIA no hace nada. Los archivos se
+ *                  conservan para auditoría. Devuelve false si no se ha
+ *                  podido escribir el archivo.
+ */
+bool guardarMuestras(BufferMuestras *buffer, FormatoMuestras formato)
+{
+    buffer->formato = formato;
+    if (formato == FORMATO_MEMORIA) return true;
+
+    snprintf(buffer->archivo, CARACTERES_ARCHIVO_MUESTRAS, "f/%08lu.%s",
+        (unsigned long) buffer->trabajo, formato == FORMATO_TEXTO ? "txt" : "bin");
+
+    bool guardado = formato == FORMATO_TEXTO ? guardarTexto(buffer) : guardarBinario(buffer);
+    if (!guardado) perror("No se pudo escribir el archivo de muestras");
+
+    return guardado;
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:     Escribe las muestras en texto, una por línea, como el
+ *              archivo original de T1.
+ *
+ * Autor:       Juan Misael Sánchez Pacheco
+ * Fecha:       17 de octubre de 2026
+ * Versión:     1.0
+ */
+static bool guardarTexto(const BufferMuestras *buffer)
+{
+    FILE *archivo = fopen(buffer->archivo, "w");
+    if (archivo == NULL) return false;
+
+    for (int i = 0; i < buffer->total; i++)
+        fprintf(archivo, "%f\n", buffer->valores[i]);
+
+    return fclose(archivo) == 0;
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:     Escribe la cabecera y las muestras empaquetadas con
+ *              una sola escritura.
+ *
+ * Autor:       Juan Misael Sánchez Pacheco
+ * Fecha:       17 de octubre de 2026
+ * Versión:     1.0
+ */
+static bool guardarBinario(const BufferMuestras *buffer)
+{
+    struct {
+        CabeceraMuestras cabecera;
+        MuestraBinaria muestras[MUESTRAS_POR_BUFFER];
+    } contenido;
+
+    contenido.cabecera.magia = MAGIA_MUESTRAS;
+    contenido.cabecera.version = VERSION_MUESTRAS;
+    contenido.cabecera.tamano_muestra = sizeof(MuestraBinaria);
+    contenido.cabecera.total = (uint32_t) buffer->total;
+    contenido.cabecera.semilla = buffer->semilla;
+    contenido.cabecera.trabajo = buffer->trabajo;
+    contenido.cabecera.reservado = 0;
+
+    for (int i = 0; i < buffer->total; i++)
+        contenido.muestras[i] = (MuestraBinaria) buffer->valores[i];
+
+    size_t tamano = sizeof(CabeceraMuestras) + (size_t) buffer->total * sizeof(MuestraBinaria);
+
+    FILE *archivo = fopen(buffer->archivo, "wb");
+    if (archivo == NULL) return false;
+
+    bool escrito = fwrite(&contenido, 1, tamano, archivo) == tamano;
+    return fclose(archivo) == 0 && escrito;
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:         Carga en el buffer las muestras de su archivo, para
+ *                  que todos sus lectores analicen la misma copia en
+ *                  memoria en vez de leer y convertir el archivo cada uno.
+ *
+ * Autor:           Juan Misael Sánchez Pacheco
+ * Fecha:           17 de octubre de 2026
+ * Versión:         1.1
+ * Observaciones:   Debe llamarse antes de compartir el buffer, mientras
+ *                  quien lo carga es su único usuario. Las muestras del
+ *                  archivo sustituyen a las del buffer, de modo que se
+ *                  analiza lo que queda auditado. Sin archivo no hace nada.
+ */
+bool cargarMuestras(BufferMuestras *buffer)
+{
+    if (buffer->formato == FORMATO_MEMORIA) return true;
+
+    LectorMuestras lector;
+    if (!abrirLectorMuestras(&lector, buffer)) return false;
+
+    int total = 0;
+    double valor = 0.0;
+    while (total < MUESTRAS_POR_BUFFER && leerMuestra(&lector, &valor))
+        buffer->valores[total++] = valor;
+
+    cerrarLectorMuestras(&lector);
+
+    buffer->formato = FORMATO_MEMORIA;
+    publicarMuestras(buffer, total);
+    cerrarMuestras(buffer);
+
+    return true;
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:         Prepara la lectura secuencial de las muestras de un
+ *                  buffer desde donde las dejó quien lo rellenó: el
+ *                  propio buffer, el archivo de texto o el binario.
+ *
+ * Autor:           Juan Misael Sánchez Pacheco
+ * Fecha:           17 de octubre de 2026
+ * Versión:         1.0
+ * Observaciones:   Devuelve false si el archivo no se puede abrir o su
+ *                  cabecera no es válida.
+ */
+bool abrirLectorMuestras(LectorMuestras *lector, const BufferMuestras *buffer)
+{
+    memset(lector, 0, sizeof(LectorMuestras));
+    lector->buffer = buffer;
+
+    switch (buffer->formato)
+    {
+        case FORMATO_TEXTO:
+            lector->texto = fopen(buffer->archivo, "r");
+            return lector->texto != NULL;
+
+        case FORMATO_BINARIO:
+            return proyectarBinario(lector);
+
+        default:
+            lector->total = (uint32_t) buffer->total;
+            return true;
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:         Proyecta en memoria el archivo binario del lector y
+ *                  comprueba su cabecera.
+ *
+ * Autor:           Juan Misael Sánchez Pacheco
+ * Fecha:           17 de octubre de 2026
+ * Versión:         1.0
+ * Observaciones:   El descriptor se cierra tras proyectarlo: la
+ *                  proyección se mantiene hasta cerrarLectorMuestras.
+ */
+static bool proyectarBinario(LectorMuestras *lector)
+{
+    int descriptor = open(lector->buffer->archivo, O_RDONLY);
+    if (descriptor < 0) return false;
+
+    struct stat estado;
+    void *mapa = MAP_FAILED;
+    if (fstat(descriptor, &estado) == 0 && (size_t) estado.st_size >= sizeof(CabeceraMuestras))
+        mapa = mmap(NULL, (size_t) estado.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    close(descriptor);
+
+    if (mapa == MAP_FAILED) return false;
+
+    lector->mapa = mapa;
+    lector->tamano_mapa = (size_t) estado.st_size;
+
+    // Cabecera válida y archivo con todas las muestras que anuncia.
+    const CabeceraMuestras *cabecera = (const CabeceraMuestras *) mapa;
+    bool valida = cabecera->magia == MAGIA_MUESTRAS && cabecera->version == VERSION_MUESTRAS &&
+        (cabecera->tamano_muestra == sizeof(float) || cabecera->tamano_muestra == sizeof(double)) &&
+        sizeof(CabeceraMuestras) + (size_t) cabecera->total * cabecera->tamano_muestra <= lector->tamano_mapa;
+
+    if (!valida)
+    {
+        cerrarLectorMuestras(lector);
+        return false;
+    }
+
+    lector->muestras = lector->mapa + sizeof(CabeceraMuestras);
+    lector->tamano_muestra = cabecera->tamano_muestra;
+    lector->total = cabecera->total;
+
+    return true;
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:     Lee la siguiente muestra. Devuelve false al terminar
+ *              las muestras.
+ *
+ * Autor:       Juan Misael Sánchez Pacheco
+ * Fecha:       17 de octubre de 2026
+ * Versión:     1.0
+ */
+bool leerMuestra(LectorMuestras *lector, double *valor)
+{
+    if (lector->texto != NULL) return fscanf(lector->texto, "%lf", valor) == 1;
+    if (lector->siguiente >= lector->total) return false;
+
+    uint32_t i = lector->siguiente++;
+
+    if (lector->mapa == NULL) *valor = lector->buffer->valores[i];
+    else if (lector->tamano_muestra == sizeof(float)) *valor = ((const float *) lector->muestras)[i];
+    else *valor = ((const double *) lector->muestras)[i];
+
+    return true;
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:     Cierra el archivo o la proyección del lector.
+ *
+ * Autor:       Juan Misael Sánchez Pacheco
+ * Fecha:       17 de octubre de 2026
+ * Versión:     1.0
+ */
+void cerrarLectorMuestras(LectorMuestras *lector)
+{
+    if (lector->texto != NULL) fclose(lector->texto);
+    if (lector->mapa != NULL) munmap((void *) lector->mapa, lector->tamano_mapa);
+
+    lector->texto = NULL;
+    lector->mapa = NULL;
+}
@@ -0,0 +1,155 @@
+/*
+ * FreeRTOS V202112.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+#ifndef MUESTRAS_H
+    #define MUESTRAS_H
+
+    #include <stdio.h>
+    #include <stdint.h>
+    #include <stddef.h>
+    #include <stdbool.h>
+    #include <stdatomic.h>
+
+    #include "FreeRTOS.h"
+    #include "event_groups.h"
+
+    #ifdef __cplusplus
+        extern "C" {
+    #endif
+
+/*-----------------------------------------------------------
+* Reserva de buffers de muestras compartidos entre tareas.
+*----------------------------------------------------------*/
+
+    // Cantidad de números decimales de cada buffer.
+    #define MUESTRAS_POR_BUFFER 200
+
+    // Buffers de la reserva: el que rellena T1, uno por cada trabajo que cabe en
+    // la cola hacia T2 (3) y uno por cada trabajo en curso en T2 (3), que conserva
+    // el suyo hasta que responden sus réplicas. Con la cola llena T1 aún tiene
+    // buffer, así que lo que se descarta lo decide la política de saturación.
+    #define TOTAL_BUFFERS_MUESTRAS 7
+
+    // Longitud máxima del nombre del archivo de muestras: "f/", el trabajo
+    // con al menos 8 cifras y la extensión.
+    #define CARACTERES_ARCHIVO_MUESTRAS 20
+
+    // Muestras de cada fragmento que publica quien rellena el buffer. Los lectores
+    // pueden analizar cada fragmento en cuanto se publica, sin esperar al resto.
+    #define MUESTRAS_POR_FRAGMENTO 25
+    #define TOTAL_FRAGMENTOS ( ( MUESTRAS_POR_BUFFER + MUESTRAS_POR_FRAGMENTO - 1 ) / MUESTRAS_POR_FRAGMENTO )
+
+    // Un bit del grupo de eventos por fragmento publicado y uno más para el cierre.
+    #define BIT_CIERRE_MUESTRAS ( ( EventBits_t ) 1 << TOTAL_FRAGMENTOS )
+    #define BITS_FRAGMENTOS ( ( BIT_CIERRE_MUESTRAS << 1 ) - 1 )
+
+    #if TOTAL_FRAGMENTOS >= 24
+        #error Un grupo de eventos solo tiene 24 bits: hacen falta fragmentos más grandes.
+    #endif
+
+    // Identificador del formato binario ("MUES") y su versión.
+    #define MAGIA_MUESTRAS 0x5345554DUL
+    #define VERSION_MUESTRAS 1
+
+    // Dónde se dejan las muestras de cada trabajo para que las lean las T3.x.
+    typedef enum {
+
+        FORMATO_MEMORIA, // Solo en el buffer, sin archivo.
+        FORMATO_TEXTO, // Archivo de texto, un "%f" por línea (formato original).
+        FORMATO_BINARIO // Archivo binario con cabecera, leído con mmap.
+
+    } FormatoMuestras;
+
+    // Buffer de muestras. Lo rellena quien lo reserva y, una vez compartido,
+    // sus lectores solo lo leen. Por las colas solo viaja su dirección.
+    typedef struct {
+
+        double valores[MUESTRAS_POR_BUFFER]; // Muestras.
+        int total; // Muestras válidas en valores, fijadas al cerrar el buffer.
+        atomic_int publicadas; // Muestras ya publicadas, que los lectores pueden leer.
+        atomic_bool cancelado; // Un lector ya tiene su resultado: no hace falta publicar más.
+        EventGroupHandle_t fragmentos; // Fragmentos publicados y cierre (BITS_FRAGMENTOS).
+        StaticEventGroup_t memoria_fragmentos; // Memoria del grupo de eventos.
+        uint32_t trabajo; // Identificador del trabajo que las generó.
+        uint32_t semilla; // Semilla del generador con el que se generaron.
+        FormatoMuestras formato; // Dónde están las muestras: en valores o en el archivo.
+        char archivo[CARACTERES_ARCHIVO_MUESTRAS]; // Archivo de auditoría, si lo hay.
+        atomic_int referencias; // Tareas que lo usan. Con 0 está libre.
+
+    } BufferMuestras;
+
+    // Cabecera del formato binario, seguida de las muestras empaquetadas.
+    typedef struct {
+
+        uint32_t magia; // MAGIA_MUESTRAS.
+        uint16_t version; // VERSION_MUESTRAS.
+        uint16_t tamano_muestra; // sizeof(float) o sizeof(double).
+        uint32_t total; // Número de muestras.
+        uint32_t semilla; // Semilla del generador.
+        uint32_t trabajo; // Identificador del trabajo.
+        uint32_t reservado; // Alinea las muestras a 8 bytes.
+
+    } CabeceraMuestras;
+
+    // Lector secuencial de las muestras de un buffer en cualquiera de los formatos.
+    typedef struct {
+
+        const BufferMuestras *buffer; // Buffer que se lee.
+        FILE *texto; // Archivo de texto abierto (FORMATO_TEXTO).
+        const unsigned char *mapa; // Archivo proyectado en memoria (FORMATO_BINARIO).
+        size_t tamano_mapa; // Bytes proyectados.
+        const void *muestras; // Primera muestra del archivo binario.
+        uint16_t tamano_muestra; // Tamaño de cada muestra del archivo binario.
+        uint32_t total; // Muestras disponibles.
+        uint32_t siguiente; // Posición de la siguiente muestra.
+
+    } LectorMuestras;
+
+    BufferMuestras *reservarMuestras( void );
+    void compartirMuestras( BufferMuestras * buffer,
+                            int lectores );
+    void liberarMuestras( BufferMuestras * buffer );
+    void publicarMuestras( BufferMuestras * buffer,
+                           int publicadas );
+    void cerrarMuestras( BufferMuestras * buffer );
+    int esperarMuestras( BufferMuestras * buffer,
+                         int leidas );
+    void cancelarMuestras( BufferMuestras * buffer );
+    bool muestrasCanceladas( BufferMuestras * buffer );
+    bool guardarMuestras( BufferMuestras * buffer,
+                          FormatoMuestras formato );
+    bool cargarMuestras( BufferMuestras * buffer );
+    bool abrirLectorMuestras( LectorMuestras * lector,
+                              const BufferMuestras * buffer );
+    bool leerMuestra( LectorMuestras * lector,
+                      double * valor );
+    void cerrarLectorMuestras( LectorMuestras * lector );
+
+    #ifdef __cplusplus
+        }
+    #endif
+
+#endif /* MUESTRAS_H */
@@ -0,0 +1,2147 @@
+/*
+ * FreeRTOS V202112.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+ /***************************************************************************************
+ * Módulo:              Planificador LLF (Least Laxity First) y registro dinámico       *
+ *                      de las tareas que planifica.                                    *
+ *                                                                                      *
+ *                      Las tareas se registran y eliminan en tiempo de ejecución.      *
+ *                      El orden lo decide una política intercambiable (LLF, EDF,       *
+ *                      RM, DM o EDZL) que se elige al compilar o al arrancar.          *
+ *                      Un control de admisión comprueba si los trabajos esporádicos    *
+ *                      caben antes de activarlos, y los sobrecostes y plazos           *
+ *                      vencidos se detectan y se contienen según cada tarea.           *
+ *                      Cuando hay más tareas activas que niveles de prioridad, las     *
+ *                      holguras se agrupan en bandas y cada banda comparte prioridad.  *
+ *                                                                                      *
+ *                      No se usan semáforos: cada tarea publica el inicio y el fin     *
+ *                      de sus trabajos de forma atómica y el LLF hace cada pasada      *
+ *                      con el planificador de FreeRTOS suspendido.                     *
+ *                                                                                      *
+ * Autor:               Juan Misael Sánchez Pacheco                                     *
+ * Fecha:               17 de octubre de 2026                                           *
+ * Versión:             1.1                                                             *
+ ****************************************************************************************/
+
+
+
+
+/*-----------------------------------------------------------*/
+
+
+
+
+/* BIBLIOTECAS */
+
+/* Bibliotecas utilizadas */
+#include <string.h>
+#include <strings.h>
+#include <stdbool.h>
+
+/* Kernel includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Local includes. */
+#include "planificador.h"
+
+
+
+
+/*-----------------------------------------------------------*/
+
+
+
+
+/* CONSTANTES. */
+
+// Periodo del planificador LLF en modo periódico.
+#define PERIODO_LLF pdMS_TO_TICKS( 1UL )    // 1 ms.
+
+// Modo de activación del planificador LLF. Con 1 el planificador se bloquea
+// hasta recibir una notificación (activación o fin de una tarea) o hasta el
+// próximo instante en el que se cruzan dos holguras. Con 0 se activa de forma
+// periódica cada PERIODO_LLF.
+#ifndef LLF_MODO_EVENTOS
+    #define LLF_MODO_EVENTOS 1
+#endif
+
+// Capacidad inicial del registro de tareas. Se duplica al llenarse.
+#define CAPACIDAD_INICIAL 16
+
+// Resolución del contador de tiempo de ejecución (ulGetRunTimeCounterValue).
+#define MICROSEGUNDOS_POR_TICK ( 1000000UL / configTICK_RATE_HZ )
+
+// Supresión del thrashing: cuando las holguras de dos tareas están muy próximas el LLF
+// puro las alterna en cada tick. La tarea en cabeza solo cede la CPU si otra la supera
+// en más de LLF_HISTERESIS ticks de holgura, y no antes de ejecutarse LLF_CUANTO_MINIMO
+// ticks. Con ambos a 0 el comportamiento es el LLF puro. Se pueden cambiar en tiempo
+// de ejecución con configurarAntiThrashingLLF.
+#ifndef LLF_HISTERESIS
+    #define LLF_HISTERESIS 0
+#endif
+
+#ifndef LLF_CUANTO_MINIMO
+    #define LLF_CUANTO_MINIMO 0
+#endif
+
+// Política con la que arranca el controlador. Se puede cambiar antes de arrancar
+// el planificador con seleccionarPoliticaPlanificacion.
+#ifndef POLITICA_PLANIFICACION
+    #define POLITICA_PLANIFICACION POLITICA_LLF
+#endif
+
+// Núcleos entre los que reparte el controlador. Un kernel SMP (FreeRTOS V11 o
+// posterior) ejecuta a la vez las configNUMBER_OF_CORES tareas listas de mayor
+// prioridad, así que el controlador solo necesita saber cuántas tareas ocupan la CPU.
+#ifdef configNUMBER_OF_CORES
+    #define NUCLEOS_LLF configNUMBER_OF_CORES
+#else
+    #define NUCLEOS_LLF 1
+#endif
+
+// Variante multiprocesador. Con 0 (global) cualquier tarea se ejecuta en cualquier
+// núcleo y ocupan la CPU las NUCLEOS_LLF de menor clave. Con 1 (particionado) cada
+// tarea se fija a un núcleo y compite solo con las tareas de ese núcleo.
+#ifndef LLF_PARTICIONADO
+    #define LLF_PARTICIONADO 0
+#endif
+
+// Núcleo que ejecuta los hooks de cambio de contexto.
+#if NUCLEOS_LLF > 1
+    #define NUCLEO_ACTUAL() ( ( int ) portGET_CORE_ID() )
+#else
+    #define NUCLEO_ACTUAL() 0
+#endif
+
+// Con un núcleo la tarea no se ejecuta mientras el controlador recorre sus datos con
+// el planificador suspendido. Con varios, una tarea de otro núcleo puede terminar un
+// trabajo y empezar el siguiente a mitad de la pasada, así que escribe los datos del
+// trabajo con el mismo bloqueo del planificador que mantiene el controlador.
+#if NUCLEOS_LLF > 1
+    #define BLOQUEAR_TRABAJO() vTaskSuspendAll()
+    #define DESBLOQUEAR_TRABAJO() ( void ) xTaskResumeAll()
+#else
+    #define BLOQUEAR_TRABAJO()
+    #define DESBLOQUEAR_TRABAJO()
+#endif
+
+// Clave que adelanta en EDZL a las tareas con holgura nula a todas las demás.
+#define CLAVE_HOLGURA_NULA ( -( BaseType_t ) ( portMAX_DELAY >> 2 ) )
+
+
+
+
+/*-----------------------------------------------------------*/
+
+
+
+
+/* VARIABLES Y DATOS. */
+
+// Interfaz de una política de planificación. La clave ordena el registro (menor
+// clave, mayor prioridad) y el cruce indica cuántos ticks faltan para que el orden
+// pueda cambiar sin que se active ni termine ninguna tarea.
+typedef struct {
+
+    const char *nombre;
+    BaseType_t (*calcularClave)(const DatosTarea *, TickType_t);
+    TickType_t (*calcularCruce)(TickType_t);
+
+} Politica;
+
+// Solicitud al control de admisión: un trabajo de cada tarea candidata, todos con
+// el mismo instante de activación y el mismo tiempo de ejecución previsto.
+typedef struct {
+
+    DatosTarea * const *candidatas;
+    int total_candidatas;
+    TickType_t instante_activacion;
+    TickType_t ejecucion;
+
+} SolicitudAdmision;
+
+// Registro de las tareas planificadas, ordenado de menor a mayor holgura.
+// Se conserva entre activaciones del LLF porque de una a otra apenas cambia el orden.
+static DatosTarea **tareas = NULL;
+static int total_tareas = 0, capacidad_tareas = 0;
+
+// Espacio auxiliar para reordenar el registro por mezcla, con su misma capacidad.
+static DatosTarea **auxiliar = NULL;
+
+// Datos de las tareas eliminadas, que la tarea idle libera cuando ya nadie puede usarlos.
+static DatosTarea *tareas_eliminadas = NULL;
+
+// Última tarea que ha salido de cada núcleo y el instante, en microsegundos del
+// contador de tiempo de ejecución, en que lo hizo: desde entonces se ejecuta la siguiente.
+static TaskHandle_t tarea_ejecutada[NUCLEOS_LLF] = { NULL }, tarea_LLF = NULL;
+static uint32_t inicio_ejecucion[NUCLEOS_LLF] = { 0 };
+
+// Tarea en cabeza del orden de ejecución e instante en que pasó a estarlo.
+static DatosTarea *tarea_en_cabeza = NULL;
+static TickType_t inicio_cabeza = 0;
+
+// Tarea cuyo cruce con la tarea en cabeza ha retrasado el anti-thrashing en la
+// última pasada e instante en que la habría adelantado sin él.
+static DatosTarea *cruce_aplazado = NULL;
+static TickType_t instante_cruce = 0;
+
+// Última tarea a la que el anti-thrashing ha impedido adelantar a la de cabeza,
+// para contar una vez cada cambio evitado.
+static DatosTarea *aspirante_retenido = NULL;
+
+// Posición en el registro de la tarea en cabeza de cada núcleo tras la última pasada
+// (-1 si no tiene tarea lista). En el LLF global son las primeras tareas listas,
+// sea cual sea el núcleo en que se ejecutan.
+static int posiciones_cabeza[NUCLEOS_LLF];
+
+// El reparto de tareas entre núcleos del LLF particionado debe rehacerse.
+static atomic_bool reparto_pendiente = false;
+
+// Parámetros del anti-thrashing y contadores del planificador.
+static TickType_t histeresis = LLF_HISTERESIS, cuanto_minimo = LLF_CUANTO_MINIMO;
+static EstadisticasLLF estadisticas = { 0 };
+
+// Política activa.
+static PoliticaPlanificacion politica_activa = POLITICA_PLANIFICACION;
+
+// Instante en que el controlador vuelve a activarse por sí mismo, si lo tiene
+// programado, para que la tarea idle no duerma más allá.
+static TickType_t despertar_LLF = 0;
+static bool despertar_LLF_programado = false;
+
+
+
+
+/*-----------------------------------------------------------*/
+
+
+
+
+// PROTOTIPOS DE FUNCIONES.
+
+// Tareas.
+static void xLLFCode( void * pvParameters );
+
+// Políticas de planificación.
+static BaseType_t claveLLF(const DatosTarea *, TickType_t);
+static BaseType_t claveEDF(const DatosTarea *, TickType_t);
+static BaseType_t claveRM(const DatosTarea *, TickType_t);
+static BaseType_t claveDM(const DatosTarea *, TickType_t);
+static BaseType_t claveEDZL(const DatosTarea *, TickType_t);
+
+// Funciones auxiliares.
+static BaseType_t calcularHolgura(const DatosTarea *, TickType_t);
+static BaseType_t calcularTiempoHastaPlazo(TickType_t, TickType_t, TickType_t);
+static void detectarIncidencias(DatosTarea *, TickType_t);
+static TickType_t calcularSiguienteIncidencia(TickType_t);
+static void actualizarEjecucionRestante(DatosTarea *);
+static bool esPlanificable(const DatosTarea *);
+static bool precedeEnOrden(const DatosTarea *, const DatosTarea *);
+static bool estaLista(const DatosTarea *);
+static bool retenerTareaEnCabeza(int, TickType_t);
+static void registrarCruceAplazado(TickType_t);
+static void ordenarRegistro(void);
+static void recalcularPrioridades(TickType_t);
+
+// Multiprocesador.
+static bool estaEnCabeza(int);
+static bool compiteEnNucleo(const DatosTarea *, int);
+static double calcularUtilizacion(const DatosTarea *);
+static void repartirNucleos(void);
+
+// Cálculo de cruces de cada política.
+static TickType_t calcularSiguienteCruce(TickType_t);
+static TickType_t calcularCruceEstatico(TickType_t);
+static TickType_t calcularCruceEDZL(TickType_t);
+
+// Control de admisión.
+static bool esCandidata(const SolicitudAdmision *, const DatosTarea *);
+static bool superaTestUtilizacion(const SolicitudAdmision *);
+static bool superaTestDemanda(const SolicitudAdmision *, TickType_t);
+static TickType_t calcularDemanda(const SolicitudAdmision *, TickType_t, BaseType_t);
+
+// Registro de tareas.
+static bool registrarTarea(DatosTarea *);
+static void desregistrarTarea(DatosTarea *);
+static void aplazarLiberacion(DatosTarea *);
+
+
+
+
+/*-----------------------------------------------------------*/
+
+
+
+
+/* POLÍTICAS DE PLANIFICACIÓN. */
+
+// Implementaciones disponibles, en el orden de PoliticaPlanificacion. Las políticas
+// de prioridad estática y EDF no tienen cruces: su orden solo cambia cuando una
+// tarea se activa o termina, que ya despierta al controlador.
+static const Politica politicas[TOTAL_POLITICAS] = {
+    [POLITICA_LLF]  = { "LLF",  claveLLF,  calcularSiguienteCruce },
+    [POLITICA_EDF]  = { "EDF",  claveEDF,  calcularCruceEstatico },
+    [POLITICA_RM]   = { "RM",   claveRM,   calcularCruceEstatico },
+    [POLITICA_DM]   = { "DM",   claveDM,   calcularCruceEstatico },
+    [POLITICA_EDZL] = { "EDZL", claveEDZL, calcularCruceEDZL },
+};
+
+
+
+
+/*-----------------------------------------------------------*/
+
+
+
+
+/*
+ * Función:     Crea el registro y la tarea del planificador LLF.
+ *              Debe llamarse antes de crear las tareas planificadas.
+ *
+ * Autor:       Juan Misael Sánchez Pacheco
+ * Fecha:       17 de octubre de 2026
+ * Versión:     1.2
+ */
+void iniciarPlanificadorLLF(void)
+{
+    // Reserva inicial del registro y de su espacio auxiliar.
+    tareas = pvPortMalloc(CAPACIDAD_INICIAL * sizeof(DatosTarea *));
+    auxiliar = pvPortMalloc(CAPACIDAD_INICIAL * sizeof(DatosTarea *));
+    capacidad_tareas = tareas != NULL && auxiliar != NULL ? CAPACIDAD_INICIAL : 0;
+
+    for (int n = 0; n < NUCLEOS_LLF; n++) posiciones_cabeza[n] = -1;
+
+    // El planificador tiene la prioridad máxima para poder expulsar a cualquier tarea.
+    xTaskCreate( xLLFCode, "LLF", configMINIMAL_STACK_SIZE, NULL, PRIORIDAD_CONTROLADOR, &tarea_LLF );
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:         Crea una tarea planificada por el LLF con el plazo
+ *                  indicado y la añade al registro. La tarea recibe sus
+ *                  datos de planificación como parámetro y también se
+ *                  guardan como su etiqueta (task tag), de modo que los
+ *                  hooks de cambio de contexto los obtienen directamente
+ *                  del TCB sin buscarlos en el registro.
+ *
+ * Autor:           Juan Misael Sánchez Pacheco
+ * Fecha:           17 de octubre de 2026
+ * Versión:         1.2
+ * Observaciones:   Devuelve NULL si no hay memoria para la tarea. El
+ *                  periodo es la separación mínima entre activaciones
+ *                  y solo lo usa RM; con 0 se toma el plazo.
+ */
+DatosTarea *crearTareaLLF(TaskFunction_t codigo, const char *nombre, TickType_t plazo, TickType_t periodo)
+{
+    DatosTarea *datos = pvPortMalloc(sizeof(DatosTarea));
+    if (datos == NULL) return NULL;
+
+    // Inicialización de los datos de la tarea a cero.
+    memset(datos, 0, sizeof(DatosTarea));
+    atomic_init(&datos->activa, false);
+    atomic_init(&datos->abortar, false);
+    atomic_init(&datos->omitir_siguiente, false);
+    atomic_init(&datos->esperando_activacion, false);
+    datos->plazo_ejecucion = plazo;
+    datos->periodo = periodo;
+    datos->prioridad = PRIORIDAD_BASE;
+
+    // Se registra antes de crearla para que el LLF la conozca desde su primera activación.
+    if (!registrarTarea(datos))
+    {
+        vPortFree(datos);
+        return NULL;
+    }
+
+    // Con el planificador suspendido la tarea no puede ejecutarse antes de tener su etiqueta.
+    vTaskSuspendAll();
+    BaseType_t creada = xTaskCreate( codigo, nombre, configMINIMAL_STACK_SIZE, datos, PRIORIDAD_BASE, &datos->handle );
+    if (creada == pdPASS) vTaskSetApplicationTaskTag(datos->handle, (TaskHookFunction_t) datos);
+    xTaskResumeAll();
+
+    if (creada != pdPASS)
+    {
+        desregistrarTarea(datos);
+        vPortFree(datos);
+        return NULL;
+    }
+
+    return datos;
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:         Retira una tarea del registro del LLF y la elimina.
+ *
+ * Autor:           Juan Misael Sánchez Pacheco
+ * Fecha:           17 de octubre de 2026
+ * Versión:         1.1
+ * Observaciones:   Si la tarea se elimina a sí misma esta función no
+ *                  retorna. Sus datos no se liberan aquí sino en la tarea
+ *                  idle (liberarTareasEliminadasLLF), una vez eliminada la
+ *                  tarea, para que ni ella ni una pasada del LLF que ya los
+ *                  hubiera leído puedan tocar memoria liberada.
+ */
+void eliminarTareaLLF(DatosTarea *datos)
+{
+    TaskHandle_t handle = datos->handle;
+
+    // Sin etiqueta, el cambio de contexto que saca a la tarea no escribe en sus datos.
+    vTaskSetApplicationTaskTag(handle, NULL);
+
+    desregistrarTarea(datos);
+
+    // El orden de prioridades cambia al desaparecer la tarea.
+    notificarLLF();
+
+    // La tarea que se elimina a sí misma deja sus datos pendientes antes, ya que
+    // vTaskDelete no retorna; la tarea idle no se ejecuta mientras ella siga en la CPU.
+    if (handle == xTaskGetCurrentTaskHandle())
+    {
+        aplazarLiberacion(datos);
+        vTaskDelete(NULL);
+    }
+    else
+    {
+        vTaskDelete(handle);
+        aplazarLiberacion(datos);
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:         Libera los datos de las tareas eliminadas con
+ *                  eliminarTareaLLF.
+ *
+ * Autor:           Juan Misael Sánchez Pacheco
+ * Fecha:           17 de octubre de 2026
+ * Versión:         1.0
+ * Observaciones:   Se llama desde el hook de la tarea idle, que también
+ *                  libera la memoria que el kernel reservó para esas
+ *                  tareas. No se bloquea.
+ */
+void liberarTareasEliminadasLLF(void)
+{
+    DatosTarea *pendientes;
+
+    vTaskSuspendAll();
+    {
+        pendientes = tareas_eliminadas;
+        tareas_eliminadas = NULL;
+    }
+    xTaskResumeAll();
+
+    while (pendientes != NULL)
+    {
+        DatosTarea *siguiente = pendientes->siguiente_eliminada;
+        vPortFree(pendientes);
+        pendientes = siguiente;
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:         Publica el inicio de un trabajo de la tarea y avisa
+ *                  al planificador LLF.
+ *
+ * Autor:           Juan Misael Sánchez Pacheco
+ * Fecha:           17 de octubre de 2026
+ * Versión:         1.3
+ * Observaciones:   Los datos del trabajo se escriben mientras la tarea
+ *                  figura inactiva, por lo que el LLF no los lee, y se
+ *                  publican al marcarla activa con semántica release.
+ *                  Con varios núcleos se escriben además con el
+ *                  planificador bloqueado para no mezclarse con una
+ *                  pasada del LLF en curso en otro núcleo.
+ *                  Devuelve false, sin activar el trabajo, si la política
+ *                  de sobrecoste del trabajo anterior pide omitir esta
+ *                  activación. Si cambia la ejecución prevista, cambia la
+ *                  carga de la tarea y el LLF particionado la reparte de nuevo.
+ */
+bool iniciarTrabajoLLF(DatosTarea *datos, TickType_t instante_activacion, TickType_t ejecucion)
+{
+    // Activación omitida por el sobrecoste del trabajo anterior.
+    if (atomic_exchange_explicit(&datos->omitir_siguiente, false, memory_order_acquire))
+    {
+        datos->activaciones_omitidas++;
+        return false;
+    }
+
+    if (ejecucion != datos->ejecucion_prevista)
+        atomic_store_explicit(&reparto_pendiente, true, memory_order_relaxed);
+
+    BLOQUEAR_TRABAJO();
+
+    // Actualización del instante de activación y reinicio de la ejecución restante.
+    datos->instante_activacion = instante_activacion;
+    datos->ejecucion_prevista = ejecucion;
+    datos->ejecucion_consumida = 0;
+    datos->ejecucion_restante = ejecucion;
+    datos->retenida = false;
+    datos->sobrecoste = false;
+    datos->plazo_vencido = false;
+    datos->degradada = false;
+    atomic_store_explicit(&datos->abortar, false, memory_order_relaxed);
+
+    // Se marca como tarea activa.
+    atomic_store_explicit(&datos->activa, true, memory_order_release);
+
+    DESBLOQUEAR_TRABAJO();
+
+    // Aviso al planificador LLF de la nueva activación.
+    notificarLLF();
+
+    return true;
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:         Publica el inicio de un trabajo que debe terminar,
+ *                  como tarde, en un plazo absoluto heredado de otro
+ *                  trabajo (por ejemplo, el plazo de extremo a extremo
+ *                  de la petición que lo origina).
+ *
+ * Autor:           Juan Misael Sánchez Pacheco
+ * Fecha:           17 de octubre de 2026
+ * Versión:         1.0
+ * Observaciones:   El plazo de un trabajo es siempre su activación más
+ *                  el plazo relativo de la tarea. Si el plazo heredado
+ *                  es anterior, el trabajo se publica como activado
+ *                  antes, de forma que su holgura y la detección de
+ *                  plazos vencidos usan el plazo heredado.
+ */
+bool iniciarTrabajoConPlazoLLF(DatosTarea *datos, TickType_t instante_activacion, TickType_t ejecucion, TickType_t plazo)
+{
+    if ((BaseType_t) (int32_t) (plazo - (instante_activacion + datos->plazo_ejecucion)) < 0)
+        instante_activacion = plazo - datos->plazo_ejecucion;
+
+    return iniciarTrabajoLLF(datos, instante_activacion, ejecucion);
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:         Indica si el LLF ha pedido abandonar el trabajo actual
+ *                  por la política SOBRECOSTE_ABORTAR.
+ *
+ * Autor:           Juan Misael Sánchez Pacheco
+ * Fecha:           17 de octubre de 2026
+ * Versión:         1.0
+ * Observaciones:   La tarea la consulta en los puntos del trabajo en los
+ *                  que puede abandonarlo y después llama a
+ *                  finalizarTrabajoLLF como en cualquier otro final.
+ */
+bool trabajoAbortadoLLF(DatosTarea *datos)
+{
+    return atomic_load_explicit(&datos->abortar, memory_order_relaxed);
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:         Configura la medida que toma el LLF cuando un trabajo
+ *                  de la tarea supera su ejecución prevista en más del
+ *                  margen indicado o su plazo vence antes de terminar.
+ *
+ * Autor:           Juan Misael Sánchez Pacheco
+ * Fecha:           17 de octubre de 2026
+ * Versión:         1.0
+ * Observaciones:   Por defecto las tareas usan SOBRECOSTE_NINGUNO.
+ */
+void configurarSobrecosteLLF(DatosTarea *datos, PoliticaSobrecoste politica, TickType_t margen)
+{
+    vTaskSuspendAll();
+    datos->politica_sobrecoste = politica;
+    datos->margen_sobrecoste = margen;
+    xTaskResumeAll();
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:         Publica el fin del trabajo actual de la tarea y
+ *                  avisa al planificador LLF.
+ *
+ * Autor:           Juan Misael Sánchez Pacheco
+ * Fecha:           17 de octubre de 2026
+ * Versión:         1.2
+ * Observaciones:   La prioridad de la tarea la devuelve a PRIORIDAD_BASE
+ *                  el propio LLF, que es el único que la modifica. El
+ *                  contador de plazos perdidos solo lo escribe la tarea.
+ *                  Con varios núcleos se bloquea el planificador como en
+ *                  iniciarTrabajoLLF.
+ */
+void finalizarTrabajoLLF(DatosTarea *datos)
+{
+    BLOQUEAR_TRABAJO();
+
+    // Trabajo terminado después de su plazo.
+    if (xTaskGetTickCount() - datos->instante_activacion > datos->plazo_ejecucion)
+        datos->plazos_perdidos++;
+
+    // Se marca como tarea inactiva.
+    atomic_store_explicit(&datos->activa, false, memory_order_release);
+
+    DESBLOQUEAR_TRABAJO();
+
+    // Aviso al planificador LLF de la finalización.
+    notificarLLF();
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:         Bloquea a una tarea periódica hasta su siguiente
+ *                  activación como vTaskDelayUntil, y antes la anuncia
+ *                  para que la tarea idle sepa cuánto puede dormir.
+ *
+ * Autor:           Juan Misael Sánchez Pacheco
+ * Fecha:           17 de octubre de 2026
+ * Versión:         1.0
+ */
+void esperarActivacionLLF(DatosTarea *datos, TickType_t *activacion, TickType_t periodo)
+{
+    datos->proxima_activacion = *activacion + periodo;
+    atomic_store_explicit(&datos->esperando_activacion, true, memory_order_release);
+
+    vTaskDelayUntil( activacion, periodo );
+
+    atomic_store_explicit(&datos->esperando_activacion, false, memory_order_relaxed);
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:         Calcula los ticks que puede dormir la tarea idle: hasta
+ *                  la próxima activación anunciada por una tarea periódica
+ *                  o la próxima activación programada del controlador.
+ *
+ * Autor:           Juan Misael Sánchez Pacheco
+ * Fecha:           17 de octubre de 2026
+ * Versión:         1.0
+ * Observaciones:   Se llama desde el hook de la tarea idle, por lo que no
+ *                  se bloquea. Devuelve 0 si alguna activación ya está
+ *                  pendiente y portMAX_DELAY si no se conoce ninguna.
+ *                  Las activaciones esporádicas y los retardos que no se
+ *                  anuncian llegan con una interrupción, que despierta a
+ *                  la tarea idle (ver vApplicationIdleHook en main.c).
+ */
+TickType_t calcularEsperaInactividadLLF(void)
+{
+    TickType_t espera = portMAX_DELAY;
+
+    vTaskSuspendAll();
+    {
+        TickType_t t_actual = xTaskGetTickCount();
+
+        if (despertar_LLF_programado)
+        {
+            BaseType_t hasta_despertar = calcularTiempoHastaPlazo(despertar_LLF, 0, t_actual);
+            espera = hasta_despertar > 0 ? (TickType_t) hasta_despertar : 0;
+        }
+
+        for (int i = 0; i < total_tareas; i++)
+        {
+            if (!atomic_load_explicit(&tareas[i]->esperando_activacion, memory_order_acquire)) continue;
+
+            BaseType_t hasta_activacion = calcularTiempoHastaPlazo(tareas[i]->proxima_activacion, 0, t_actual);
+            if (hasta_activacion <= 0) espera = 0;
+            else if ((TickType_t) hasta_activacion < espera) espera = (TickType_t) hasta_activacion;
+        }
+    }
+    xTaskResumeAll();
+
+    return espera;
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:         Acumula en las estadísticas una espera de la tarea
+ *                  idle: el tiempo dormido y el retraso del despertar
+ *                  sobre el instante previsto, ambos en microsegundos.
+ *
+ * Autor:           Juan Misael Sánchez Pacheco
+ * Fecha:           17 de octubre de 2026
+ * Versión:         1.0
+ * Observaciones:   Las esperas interrumpidas por una señal no tienen
+ *                  retraso y se cuentan aparte.
+ */
+void registrarInactividadLLF(uint32_t inactivo, uint32_t latencia, bool anticipado)
+{
+    vTaskSuspendAll();
+    {
+        estadisticas.tiempo_inactivo += inactivo;
+
+        if (anticipado)
+        {
+            estadisticas.despertares_anticipados++;
+        }
+        else
+        {
+            estadisticas.despertares++;
+            estadisticas.latencia_despertar_total += latencia;
+            if (latencia > estadisticas.latencia_despertar_maxima) estadisticas.latencia_despertar_maxima = latencia;
+        }
+    }
+    xTaskResumeAll();
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:         Ajusta la supresión del thrashing del LLF: la
+ *                  histéresis de holgura, en ticks, que debe superar otra
+ *                  tarea para desplazar a la que está en cabeza, y el
+ *                  cuanto mínimo, en ticks, que esta se ejecuta antes de
+ *                  poder ser desplazada.
+ *
+ * Autor:           Juan Misael Sánchez Pacheco
+ * Fecha:           17 de octubre de 2026
+ * Versión:         1.0
+ * Observaciones:   Con ambos valores a 0 el planificador es LLF puro. Una
+ *                  tarea con holgura nula o negativa desplaza siempre a la
+ *                  que está en cabeza.
+ */
+void configurarAntiThrashingLLF(TickType_t nueva_histeresis, TickType_t nuevo_cuanto)
+{
+    vTaskSuspendAll();
+    histeresis = nueva_histeresis;
+    cuanto_minimo = nuevo_cuanto;
+    xTaskResumeAll();
+
+    // El siguiente cruce de holguras cambia con los nuevos parámetros.
+    notificarLLF();
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:     Copia los contadores del planificador LLF.
+ *
+ * Autor:       Juan Misael Sánchez Pacheco
+ * Fecha:       17 de octubre de 2026
+ * Versión:     1.0
+ */
+void obtenerEstadisticasLLF(EstadisticasLLF *copia)
+{
+    // Copia coherente: el LLF solo los modifica con el planificador suspendido.
+    vTaskSuspendAll();
+    *copia = estadisticas;
+    copia->plazos_perdidos = 0;
+    copia->sobrecostes = 0;
+    copia->activaciones_omitidas = 0;
+    for (int i = 0; i < total_tareas; i++)
+    {
+        copia->plazos_perdidos += tareas[i]->plazos_perdidos;
+        copia->sobrecostes += tareas[i]->sobrecostes;
+        copia->activaciones_omitidas += tareas[i]->activaciones_omitidas;
+    }
+    xTaskResumeAll();
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:         Copia los contadores de incidencias de cada tarea
+ *                  registrada, hasta la capacidad indicada.
+ *
+ * Autor:           Juan Misael Sánchez Pacheco
+ * Fecha:           17 de octubre de 2026
+ * Versión:         1.0
+ * Observaciones:   Devuelve la cantidad de tareas copiadas.
+ */
+int obtenerIncidenciasLLF(IncidenciasTarea *incidencias, int capacidad)
+{
+    int copiadas = 0;
+
+    vTaskSuspendAll();
+    for ( ; copiadas < total_tareas && copiadas < capacidad; copiadas++)
+    {
+        const DatosTarea *tarea = tareas[copiadas];
+        incidencias[copiadas].nombre = pcTaskGetName(tarea->handle);
+        incidencias[copiadas].plazos_perdidos = tarea->plazos_perdidos;
+        incidencias[copiadas].sobrecostes = tarea->sobrecostes;
+        incidencias[copiadas].activaciones_omitidas = tarea->activaciones_omitidas;
+    }
+    xTaskResumeAll();
+
+    return copiadas;
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:         Cambia la política con la que el controlador ordena
+ *                  las tareas.
+ *
+ * Autor:           Juan Misael Sánchez Pacheco
+ * Fecha:           17 de octubre de 2026
+ * Versión:         1.0
+ * Observaciones:   Puede llamarse antes de arrancar el planificador o
+ *                  durante la ejecución; el nuevo orden se aplica en la
+ *                  siguiente pasada del controlador.
+ */
+void seleccionarPoliticaPlanificacion(PoliticaPlanificacion politica)
+{
+    if (politica >= TOTAL_POLITICAS) return;
+
+    vTaskSuspendAll();
+    politica_activa = politica;
+    xTaskResumeAll();
+
+    notificarLLF();
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:         Busca una política por su nombre (LLF, EDF, RM, DM o
+ *                  EDZL) sin distinguir mayúsculas.
+ *
+ * Autor:           Juan Misael Sánchez Pacheco
+ * Fecha:           17 de octubre de 2026
+ * Versión:         1.0
+ * Observaciones:   Devuelve false si el nombre no corresponde a ninguna.
+ */
+bool buscarPoliticaPlanificacion(const char *nombre, PoliticaPlanificacion *politica)
+{
+    for (int i = 0; i < TOTAL_POLITICAS; i++)
+    {
+        if (strcasecmp(nombre, politicas[i].nombre) != 0) continue;
+
+        *politica = (PoliticaPlanificacion) i;
+        return true;
+    }
+
+    return false;
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:     Devuelve el nombre de la política activa.
+ *
+ * Autor:       Juan Misael Sánchez Pacheco
+ * Fecha:       17 de octubre de 2026
+ * Versión:     1.0
+ */
+const char *obtenerNombrePolitica(void)
+{
+    return politicas[politica_activa].nombre;
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:         Control de admisión de trabajos esporádicos. Comprueba
+ *                  si un trabajo de cada tarea candidata, activado en el
+ *                  instante indicado, cabe junto a los trabajos activos y
+ *                  las próximas activaciones de las tareas periódicas.
+ *
+ * Autor:           Juan Misael Sánchez Pacheco
+ * Fecha:           17 de octubre de 2026
+ * Versión:         1.0
+ * Observaciones:   Se aplican dos pruebas. La de utilización (suma de C/T
+ *                  de las tareas con periodo) detecta la sobrecarga
+ *                  permanente y rechaza la solicitud. La de demanda de
+ *                  procesador comprueba, en cada plazo absoluto pendiente,
+ *                  que el trabajo que vence antes de él cabe en el tiempo
+ *                  que queda; si no se cumple, la solicitud se aplaza
+ *                  mientras las candidatas aún tengan margen para esperar,
+ *                  y si no, se rechaza. La solicitud no reserva nada: el
+ *                  trabajo se activa después con iniciarTrabajoLLF.
+ */
+ResultadoAdmision comprobarAdmisionLLF(DatosTarea * const *candidatas, int total_candidatas,
+                                       TickType_t instante_activacion, TickType_t ejecucion)
+{
+    const SolicitudAdmision solicitud = { candidatas, total_candidatas, instante_activacion, ejecucion };
+    ResultadoAdmision resultado = ADMISION_ADMITIDA;
+
+    // Con el planificador suspendido los trabajos activos no cambian durante las pruebas.
+    vTaskSuspendAll();
+    {
+        TickType_t t_actual = xTaskGetTickCount();
+
+        if (!superaTestUtilizacion(&solicitud))
+        {
+            resultado = ADMISION_RECHAZADA;
+        }
+        else if (!superaTestDemanda(&solicitud, t_actual))
+        {
+            // Se aplaza solo si todas las candidatas pueden esperar al menos un tick.
+            resultado = ADMISION_APLAZADA;
+            for (int i = 0; i < total_candidatas; i++)
+            {
+                BaseType_t margen = calcularTiempoHastaPlazo(instante_activacion, candidatas[i]->plazo_ejecucion, t_actual);
+                if (margen <= (BaseType_t) ejecucion) resultado = ADMISION_RECHAZADA;
+            }
+        }
+
+        if (resultado == ADMISION_ADMITIDA) estadisticas.trabajos_admitidos++;
+        else if (resultado == ADMISION_APLAZADA) estadisticas.trabajos_aplazados++;
+        else estadisticas.trabajos_rechazados++;
+    }
+    xTaskResumeAll();
+
+    return resultado;
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Tarea:       Planificador personalizado que utiliza
+ *              un sistema de planificación LLF (Least Laxity
+ *              First).
+
+ * Autor:       Juan Misael Sánchez Pacheco
+ * Fecha:       16 de mayo de 2025
+ * Versión:     1.2
+ */
+static void xLLFCode(void * pvParameters )
+{
+    ( void ) pvParameters;
+
+    // Se actualiza con el último instante de activación
+    // para poder controlar su periodo.
+    TickType_t ultima_activacion = xTaskGetTickCount();
+
+    while(true)
+    {
+        // Pasada del controlador y tiempo hasta que su orden deja de ser válido.
+        TickType_t espera = ejecutarPasadaLLF();
+
+#if LLF_MODO_EVENTOS
+        // Espera a una activación o finalización de tarea, o al siguiente cruce de holguras.
+        ( void ) ultima_activacion;
+        despertar_LLF = xTaskGetTickCount() + espera;
+        despertar_LLF_programado = espera != portMAX_DELAY;
+        ulTaskNotifyTake( pdTRUE, espera );
+#else
+        // Periodo de activación.
+        ( void ) espera;
+        despertar_LLF = ultima_activacion + PERIODO_LLF;
+        despertar_LLF_programado = true;
+        vTaskDelayUntil( &ultima_activacion, PERIODO_LLF);
+#endif
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:         Pasada del controlador: actualiza la holgura y la
+ *                  clave de cada tarea activa, reparte las prioridades y
+ *                  calcula los ticks que faltan para que el orden deje de
+ *                  ser válido.
+ *
+ * Autor:           Juan Misael Sánchez Pacheco
+ * Fecha:           17 de octubre de 2026
+ * Versión:         1.1
+ * Observaciones:   La ejecuta la tarea del LLF y también el simulador de
+ *                  eventos discretos (simulador.c), que la llama en cada
+ *                  evento del tiempo simulado. Devuelve portMAX_DELAY si
+ *                  el orden no cambia hasta el próximo evento.
+ */
+TickType_t ejecutarPasadaLLF(void)
+{
+    // Instante de tiempo actual.
+    TickType_t t_actual = xTaskGetTickCount();
+
+    // Tiempo hasta el próximo cruce de claves. Sin tareas
+    // que compitan no hay cruces y se espera indefinidamente.
+    TickType_t espera = portMAX_DELAY;
+
+    // Acceso seguro a los datos de las tareas: con el planificador suspendido ninguna
+    // tarea puede modificar el registro ni cambia de contexto a mitad de la pasada.
+    vTaskSuspendAll();
+    {
+        // Inicio de la pasada para medir el coste del controlador.
+        uint32_t inicio_pasada = (uint32_t) ulGetRunTimeCounterValue();
+        const Politica *politica = &politicas[politica_activa];
+
+        // Calcular holgura y clave para cada tarea activa a partir del tiempo de CPU
+        // que acumula registrarSalidaTarea en cada cambio de contexto.
+        for (int i = 0; i < total_tareas; i++)
+        {
+            if (!atomic_load_explicit(&tareas[i]->activa, memory_order_acquire)) continue;
+
+            // Se calcula la holgura para las tareas activas, tras aplicar
+            // la política de sobrecoste si el trabajo ya no cumple.
+            actualizarEjecucionRestante(tareas[i]);
+            detectarIncidencias(tareas[i], t_actual);
+            if(esPlanificable(tareas[i]))
+            {
+                tareas[i]->holgura = calcularHolgura(tareas[i], t_actual);
+                tareas[i]->clave = politica->calcularClave(tareas[i], t_actual);
+            }
+        }
+
+        // Nuevo reparto entre núcleos del LLF particionado si ha cambiado la carga de alguna tarea.
+        if (atomic_exchange_explicit(&reparto_pendiente, false, memory_order_relaxed) && LLF_PARTICIONADO)
+            repartirNucleos();
+
+        // Se establecen las prioridades tras actualizar cada clave.
+        recalcularPrioridades(t_actual);
+
+        // Instante en el que el nuevo orden de prioridades deja de ser válido,
+        // o antes si un trabajo activo agota su presupuesto o su plazo.
+        espera = politica->calcularCruce(t_actual);
+        TickType_t incidencia = calcularSiguienteIncidencia(t_actual);
+        if (incidencia < espera) espera = incidencia;
+
+        estadisticas.pasadas_controlador++;
+        estadisticas.tiempo_controlador += (uint32_t) ulGetRunTimeCounterValue() - inicio_pasada;
+    }
+    // Se reanuda el planificador y, si procede, se produce el único cambio de contexto.
+    xTaskResumeAll();
+
+    return espera;
+}
+
+
+
+
+/*-----------------------------------------------------------*/
+
+
+
+
+/*
+ * Función:     Clave de LLF: la holgura.
+ *
+ * Autor:       Juan Misael Sánchez Pacheco
+ * Fecha:       17 de octubre de 2026
+ * Versión:     1.0
+ */
+static BaseType_t claveLLF(const DatosTarea *tarea, TickType_t t_actual)
+{
+    ( void ) t_actual;
+    return tarea->holgura;
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:     Clave de EDF: los ticks que faltan para el plazo
+ *              absoluto. Decrece igual para todas las tareas, por lo que
+ *              ordena como el propio plazo absoluto.
+ *
+ * Autor:       Juan Misael Sánchez Pacheco
+ * Fecha:       17 de octubre de 2026
+ * Versión:     1.0
+ */
+static BaseType_t claveEDF(const DatosTarea *tarea, TickType_t t_actual)
+{
+    ( void ) t_actual;
+    return tarea->holgura + (BaseType_t) tarea->ejecucion_restante;
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:     Clave de RM: el periodo, o el plazo si la tarea no
+ *              tiene periodo conocido.
+ *
+ * Autor:       Juan Misael Sánchez Pacheco
+ * Fecha:       17 de octubre de 2026
+ * Versión:     1.0
+ */
+static BaseType_t claveRM(const DatosTarea *tarea, TickType_t t_actual)
+{
+    ( void ) t_actual;
+    return (BaseType_t) (tarea->periodo > 0 ? tarea->periodo : tarea->plazo_ejecucion);
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:     Clave de DM: el plazo relativo.
+ *
+ * Autor:       Juan Misael Sánchez Pacheco
+ * Fecha:       17 de octubre de 2026
+ * Versión:     1.0
+ */
+static BaseType_t claveDM(const DatosTarea *tarea, TickType_t t_actual)
+{
+    ( void ) t_actual;
+    return (BaseType_t) tarea->plazo_ejecucion;
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:     Clave de EDZL: la de EDF, salvo que las tareas sin
+ *              holgura pasan delante de todas las demás.
+ *
+ * Autor:       Juan Misael Sánchez Pacheco
+ * Fecha:       17 de octubre de 2026
+ * Versión:     1.0
+ */
+static BaseType_t claveEDZL(const DatosTarea *tarea, TickType_t t_actual)
+{
+    BaseType_t clave = claveEDF(tarea, t_actual);
+    return tarea->holgura <= 0 ? CLAVE_HOLGURA_NULA + clave : clave;
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:         Calcula la holgura para una tarea en un instante de tiempo.
+ * Autor:           Juan Misael Sánchez Pacheco
+ * Fecha:           16 de mayo de 2025
+ * Versión:         1.1
+ * Observaciones:   Se calcula con signo para que un plazo vencido dé una
+ *                  holgura negativa en vez de desbordar la resta sin signo.
+ */
+static BaseType_t calcularHolgura(const DatosTarea *tarea, TickType_t t_actual)
+{
+    return calcularTiempoHastaPlazo(tarea->instante_activacion, tarea->plazo_ejecucion, t_actual)
+        - (BaseType_t) tarea->ejecucion_restante;
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:         Detecta si el trabajo activo de una tarea ha agotado
+ *                  su presupuesto (ejecución prevista más margen) o si su
+ *                  plazo ha vencido, y aplica su política de sobrecoste.
+ *
+ * Autor:           Juan Misael Sánchez Pacheco
+ * Fecha:           17 de octubre de 2026
+ * Versión:         1.0
+ * Observaciones:   Cada incidencia se detecta una vez por trabajo y la
+ *                  política se aplica con la primera. Solo el LLF escribe
+ *                  estos campos mientras el trabajo está activo.
+ */
+static void detectarIncidencias(DatosTarea *tarea, TickType_t t_actual)
+{
+    bool aplicada = tarea->sobrecoste || tarea->plazo_vencido;
+
+    // Sobrecoste: la ejecución consumida supera el presupuesto.
+    TickType_t consumido = tarea->ejecucion_consumida / MICROSEGUNDOS_POR_TICK;
+    if (!tarea->sobrecoste && consumido > tarea->ejecucion_prevista + tarea->margen_sobrecoste)
+    {
+        tarea->sobrecoste = true;
+        tarea->sobrecostes++;
+    }
+
+    // Plazo vencido con el trabajo aún activo. El plazo perdido lo cuenta la tarea al terminar.
+    if (!tarea->plazo_vencido &&
+        calcularTiempoHastaPlazo(tarea->instante_activacion, tarea->plazo_ejecucion, t_actual) < 0)
+        tarea->plazo_vencido = true;
+
+    if (aplicada || !(tarea->sobrecoste || tarea->plazo_vencido)) return;
+
+    switch (tarea->politica_sobrecoste)
+    {
+        case SOBRECOSTE_ABORTAR:
+            atomic_store_explicit(&tarea->abortar, true, memory_order_relaxed);
+            tarea->degradada = true;
+            break;
+
+        case SOBRECOSTE_DEGRADAR:
+            tarea->degradada = true;
+            break;
+
+        case SOBRECOSTE_OMITIR_SIGUIENTE:
+            atomic_store_explicit(&tarea->omitir_siguiente, true, memory_order_release);
+            break;
+
+        default:
+            break;
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:         Calcula los ticks que faltan para la próxima incidencia
+ *                  posible: el vencimiento del plazo de un trabajo activo o
+ *                  el fin del presupuesto de una de las tareas que se
+ *                  ejecutan, que son las únicas que lo consumen.
+ *
+ * Autor:           Juan Misael Sánchez Pacheco
+ * Fecha:           17 de octubre de 2026
+ * Versión:         1.1
+ * Observaciones:   Debe llamarse con el planificador suspendido y tras
+ *                  recalcularPrioridades. Devuelve portMAX_DELAY si no
+ *                  hay ninguna incidencia pendiente.
+ */
+static TickType_t calcularSiguienteIncidencia(TickType_t t_actual)
+{
+    TickType_t espera = portMAX_DELAY;
+
+    for (int i = 0; i < total_tareas; i++)
+    {
+        const DatosTarea *tarea = tareas[i];
+        if (tarea->plazo_vencido || !atomic_load_explicit(&tarea->activa, memory_order_acquire)) continue;
+
+        // El plazo vence al tick siguiente a alcanzarse.
+        BaseType_t hasta_plazo = calcularTiempoHastaPlazo(tarea->instante_activacion, tarea->plazo_ejecucion, t_actual);
+        if (hasta_plazo >= 0 && (TickType_t) hasta_plazo + 1 < espera) espera = (TickType_t) hasta_plazo + 1;
+    }
+
+    for (int n = 0; n < NUCLEOS_LLF; n++)
+    {
+        if (posiciones_cabeza[n] < 0 || tareas[posiciones_cabeza[n]]->sobrecoste) continue;
+
+        const DatosTarea *cabeza = tareas[posiciones_cabeza[n]];
+        TickType_t consumido = cabeza->ejecucion_consumida / MICROSEGUNDOS_POR_TICK;
+        TickType_t presupuesto = cabeza->ejecucion_prevista + cabeza->margen_sobrecoste;
+
+        if (consumido <= presupuesto && presupuesto - consumido + 1 < espera) espera = presupuesto - consumido + 1;
+    }
+
+    return espera;
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:         Actualiza el tiempo de ejecución restante de una
+ *                  tarea con el tiempo de CPU que ha consumido.
+ *
+ * Autor:           Juan Misael Sánchez Pacheco
+ * Fecha:           17 de octubre de 2026
+ * Versión:         1.0
+ * Observaciones:   El consumo se acumula en microsegundos y se convierte
+ *                  a ticks solo aquí, por lo que los redondeos no se
+ *                  acumulan cambio de contexto a cambio de contexto. Se
+ *                  redondea a la baja, lo que deja la holgura del lado seguro.
+ */
+static void actualizarEjecucionRestante(DatosTarea *tarea)
+{
+    TickType_t consumido = tarea->ejecucion_consumida / MICROSEGUNDOS_POR_TICK;
+
+    tarea->ejecucion_restante = consumido < tarea->ejecucion_prevista ?
+        tarea->ejecucion_prevista - consumido : 0;
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:     Indica si una tarea compite por la CPU en el LLF: está
+ *              activa, aún le queda tiempo de ejecución y su política de
+ *              sobrecoste no la ha pasado a segundo plano.
+ *
+ * Autor:       Juan Misael Sánchez Pacheco
+ * Fecha:       17 de octubre de 2026
+ * Versión:     1.1
+ */
+static bool esPlanificable(const DatosTarea *tarea)
+{
+    // La lectura con semántica acquire garantiza ver los datos publicados con el trabajo.
+    return atomic_load_explicit(&tarea->activa, memory_order_acquire) &&
+        tarea->ejecucion_restante > 0 && !tarea->degradada;
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:     Criterio de orden del índice. Las tareas planificables
+ *              van delante y, entre ellas, las de menor clave según la
+ *              política activa. Con claves iguales se respeta el orden previo.
+ *
+ * Autor:       Juan Misael Sánchez Pacheco
+ * Fecha:       17 de octubre de 2026
+ * Versión:     1.1
+ */
+static bool precedeEnOrden(const DatosTarea *a, const DatosTarea *b)
+{
+    if (!esPlanificable(a)) return false;
+    if (!esPlanificable(b)) return true;
+
+    return a->clave < b->clave;
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:     Indica si una tarea puede ocupar la CPU: está lista o en
+ *              ejecución. Las tareas bloqueadas no consumen CPU aunque
+ *              tengan la mayor prioridad.
+ *
+ * Autor:       Juan Misael Sánchez Pacheco
+ * Fecha:       17 de octubre de 2026
+ * Versión:     1.0
+ */
+static bool estaLista(const DatosTarea *tarea)
+{
+    eTaskState estado = eTaskGetState(tarea->handle);
+    return estado == eReady || estado == eRunning;
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:         Mantiene en cabeza del orden de ejecución a la tarea
+ *                  que ya lo estaba cuando otra la adelanta en holgura por
+ *                  no más de la histéresis o antes de agotar su cuanto
+ *                  mínimo. Las tareas que adelanta se marcan como retenidas.
+ *
+ * Autor:           Juan Misael Sánchez Pacheco
+ * Fecha:           17 de octubre de 2026
+ * Versión:         1.2
+ * Observaciones:   Se llama con el registro ya ordenado y la cabeza
+ *                  calculada. Solo se usa con un núcleo. Devuelve true si ha retenido a la tarea en
+ *                  cabeza. Nunca retrasa a una tarea con holgura nula o
+ *                  negativa.
+ */
+static bool retenerTareaEnCabeza(int planificables, TickType_t t_actual)
+{
+    int posicion_cabeza = posiciones_cabeza[0];
+    DatosTarea *aspirante = tareas[posicion_cabeza];
+    bool retener = tarea_en_cabeza != NULL && aspirante != tarea_en_cabeza;
+
+    // La tarea en cabeza debe seguir compitiendo por la CPU y estar lista.
+    int posicion = posicion_cabeza + 1;
+    while (retener && posicion < planificables && tareas[posicion] != tarea_en_cabeza) posicion++;
+    retener = retener && posicion < planificables && estaLista(tarea_en_cabeza);
+
+    // Una tarea sin holgura no puede esperar sin perder su plazo.
+    if (retener)
+    {
+        bool dentro_histeresis = tarea_en_cabeza->holgura - aspirante->holgura <= (BaseType_t) histeresis;
+        bool dentro_cuanto = (TickType_t) (t_actual - inicio_cabeza) < cuanto_minimo;
+        retener = aspirante->holgura > 0 && (dentro_histeresis || dentro_cuanto);
+    }
+
+    if (!retener)
+    {
+        aspirante_retenido = NULL;
+        return false;
+    }
+
+    // Se adelanta la tarea en cabeza y las que tenía delante esperan un puesto.
+    for (int i = posicion; i > posicion_cabeza; i--)
+    {
+        tareas[i] = tareas[i - 1];
+        if (estaLista(tareas[i])) tareas[i]->retenida = true;
+    }
+    tareas[posicion_cabeza] = tarea_en_cabeza;
+
+    if (aspirante != aspirante_retenido) estadisticas.cambios_evitados++;
+    aspirante_retenido = aspirante;
+
+    return true;
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:         Cuenta el cambio de contexto que ha evitado el
+ *                  anti-thrashing al retrasar el cruce de la última
+ *                  pasada, si la tarea en cabeza ha conservado la CPU
+ *                  más allá del instante en que la otra la adelantaba.
+ *
+ * Autor:           Juan Misael Sánchez Pacheco
+ * Fecha:           17 de octubre de 2026
+ * Versión:         1.0
+ * Observaciones:   En modo eventos el controlador no se activa dentro de
+ *                  la histéresis ni del cuanto mínimo (ver
+ *                  calcularSiguienteCruce), así que el cambio evitado se
+ *                  cuenta en la pasada siguiente. La tarea adelantada se
+ *                  marca como retenida para contar sus plazos perdidos.
+ */
+static void registrarCruceAplazado(TickType_t t_actual)
+{
+    DatosTarea *aplazada = cruce_aplazado;
+    cruce_aplazado = NULL;
+
+    // Si la pasada llega antes del cruce, el orden aún no había cambiado.
+    if (aplazada == NULL || (BaseType_t) (int32_t) (t_actual - instante_cruce) < 0 || !esPlanificable(aplazada))
+        return;
+
+    aplazada->retenida = true;
+    if (aplazada != aspirante_retenido) estadisticas.cambios_evitados++;
+    aspirante_retenido = aplazada;
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:         Ordena el registro de forma estable según
+ *                  precedeEnOrden, mezclando los tramos que ya están
+ *                  ordenados (natural merge sort).
+ *
+ * Autor:           Juan Misael Sánchez Pacheco
+ * Fecha:           17 de octubre de 2026
+ * Versión:         1.0
+ * Observaciones:   Cada pasada mezcla los tramos de dos en dos sobre el
+ *                  espacio auxiliar, así que hacen falta log2 del número
+ *                  de tramos pasadas: O(n) si el registro ya está casi
+ *                  ordenado y O(n log n) en el peor caso. Se llama con el
+ *                  planificador suspendido.
+ */
+static void ordenarRegistro(void)
+{
+    DatosTarea **origen = tareas, **destino = auxiliar;
+
+    while (true)
+    {
+        // Si el primer tramo ordenado ocupa todo el registro, ya está.
+        int fin = 1;
+        while (fin < total_tareas && !precedeEnOrden(origen[fin], origen[fin - 1])) fin++;
+        if (fin >= total_tareas) break;
+
+        // Mezcla de cada par de tramos consecutivos. Con claves iguales pasa antes
+        // la tarea del primer tramo.
+        for (int inicio = 0, copiadas = 0; inicio < total_tareas; inicio = fin)
+        {
+            int medio = inicio + 1;
+            while (medio < total_tareas && !precedeEnOrden(origen[medio], origen[medio - 1])) medio++;
+
+            fin = medio < total_tareas ? medio + 1 : medio;
+            while (fin < total_tareas && !precedeEnOrden(origen[fin], origen[fin - 1])) fin++;
+
+            int a = inicio, b = medio;
+            while (a < medio && b < fin) destino[copiadas++] = precedeEnOrden(origen[b], origen[a]) ? origen[b++] : origen[a++];
+            while (a < medio) destino[copiadas++] = origen[a++];
+            while (b < fin) destino[copiadas++] = origen[b++];
+        }
+
+        DatosTarea **mezclado = destino;
+        destino = origen;
+        origen = mezclado;
+    }
+
+    // El resultado de la última pasada puede haber quedado en el espacio auxiliar.
+    if (origen != tareas) memcpy(tareas, origen, total_tareas * sizeof(DatosTarea *));
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:         Recalcula las prioridades de cada tarea según
+ *                  la clave actual de la política activa.
+ *
+ * Autor:           Juan Misael Sánchez Pacheco
+ * Fecha:           16 de mayo de 2025
+ * Versión:         1.7
+ * Observaciones:   Entre dos activaciones del LLF solo cambia la holgura
+ *                  relativa de las tareas que se han ejecutado o se han
+ *                  activado, ya que las que esperan pierden holgura al mismo
+ *                  ritmo. Por eso se reordena el registro anterior por mezcla
+ *                  de tramos ya ordenados (ver ordenarRegistro), que cuesta
+ *                  O(n) sobre un registro casi ordenado y O(n log n) en el peor
+ *                  caso, y solo se cambia la prioridad de las tareas cuyo
+ *                  puesto ha variado.
+ *                  Se llama con el planificador suspendido, así que todos los
+ *                  cambios provocan como mucho un cambio de contexto por pasada.
+ *                  Las tareas que dejan de ser planificables vuelven a
+ *                  PRIORIDAD_BASE.
+ *
+ *                  Si hay más tareas planificables que NIVELES_PRIORIDAD, el
+ *                  rango de claves se divide en NIVELES_PRIORIDAD bandas
+ *                  iguales y las tareas de una misma banda comparten prioridad.
+ *
+ *                  Con el anti-thrashing activo la tarea en cabeza puede
+ *                  conservar su puesto aunque no tenga la menor holgura
+ *                  (ver retenerTareaEnCabeza).
+ *
+ *                  Con varios núcleos el mismo orden sirve para el LLF
+ *                  global y el particionado: el kernel SMP ejecuta en cada
+ *                  núcleo la tarea lista de mayor prioridad de las que
+ *                  puede ejecutar, y las prioridades de las tareas de un
+ *                  mismo núcleo conservan su orden relativo.
+ */
+static void recalcularPrioridades(TickType_t t_actual)
+{
+    // Reordenación estable del registro por clave.
+    ordenarRegistro();
+
+    // Las tareas planificables están al principio del registro.
+    int planificables = 0;
+    while (planificables < total_tareas && esPlanificable(tareas[planificables])) planificables++;
+
+    // Las tareas que pasan a ejecutarse son, en cada núcleo, la primera lista en el
+    // orden de prioridades de las que compiten en él. En el LLF global, las
+    // NUCLEOS_LLF primeras tareas listas.
+    int cabezas = 0;
+    for (int n = 0; n < NUCLEOS_LLF; n++) posiciones_cabeza[n] = -1;
+    for (int i = 0; i < planificables && cabezas < NUCLEOS_LLF; i++)
+    {
+        int nucleo = LLF_PARTICIONADO ? (int) tareas[i]->nucleo : cabezas;
+        if (posiciones_cabeza[nucleo] >= 0 || !estaLista(tareas[i])) continue;
+
+        posiciones_cabeza[nucleo] = i;
+        cabezas++;
+    }
+    int posicion_cabeza = posiciones_cabeza[0];
+
+    // Supresión del thrashing, que solo tiene sentido con LLF y un núcleo. Primero
+    // se cuenta el cruce que retrasó la pasada anterior, si la cabeza lo superó.
+    registrarCruceAplazado(t_actual);
+    bool cabeza_retenida = false;
+    if (NUCLEOS_LLF == 1 && politica_activa == POLITICA_LLF && posicion_cabeza >= 0 && (histeresis > 0 || cuanto_minimo > 0))
+        cabeza_retenida = retenerTareaEnCabeza(planificables, t_actual);
+
+    // El cuanto mínimo se mide desde que la tarea pasa a estar en cabeza.
+    DatosTarea *cabeza = posicion_cabeza >= 0 ? tareas[posicion_cabeza] : NULL;
+    if (cabeza != tarea_en_cabeza)
+    {
+        tarea_en_cabeza = cabeza;
+        inicio_cabeza = t_actual;
+    }
+
+    // Plazos que se pierden tras haber retrasado el anti-thrashing a la tarea. Se
+    // cuentan una vez por trabajo, en cuanto su holgura pasa a ser negativa.
+    for (int i = 0; i < planificables; i++)
+    {
+        if (tareas[i]->retenida && tareas[i]->holgura < 0)
+        {
+            estadisticas.perdidas_introducidas++;
+            tareas[i]->retenida = false;
+        }
+    }
+
+    // Anchura de cada banda de claves. Sin bandas cada tarea tiene su propio nivel.
+    // La tarea retenida puede romper el orden por clave, por lo que se buscan los extremos.
+    bool bandas = planificables > NIVELES_PRIORIDAD;
+    BaseType_t clave_minima = 0;
+    TickType_t anchura_banda = 1;
+    if (bandas)
+    {
+        BaseType_t clave_maxima = tareas[0]->clave;
+        clave_minima = tareas[0]->clave;
+        for (int i = 1; i < planificables; i++)
+        {
+            if (tareas[i]->clave < clave_minima) clave_minima = tareas[i]->clave;
+            if (tareas[i]->clave > clave_maxima) clave_maxima = tareas[i]->clave;
+        }
+
+        TickType_t rango = clave_maxima - clave_minima + 1;
+        anchura_banda = (rango + NIVELES_PRIORIDAD - 1) / NIVELES_PRIORIDAD;
+    }
+
+    // Asignación de prioridades decrecientes en el orden del registro. La prioridad
+    // máxima posible es una menor que la del LLF.
+    UBaseType_t nivel_anterior = 0;
+    for (int i = 0; i < planificables; i++)
+    {
+        DatosTarea *tarea = tareas[i];
+        UBaseType_t nivel = bandas ? (TickType_t) (tarea->clave - clave_minima) / anchura_banda : (UBaseType_t) i;
+
+        // Ninguna tarea queda por encima de otra que la precede en el registro, y la
+        // tarea retenida no comparte nivel con las que adelanta para no turnarse con ellas.
+        if (nivel < nivel_anterior) nivel = nivel_anterior;
+        if (cabeza_retenida && i == posicion_cabeza + 1 && nivel == nivel_anterior && nivel < NIVELES_PRIORIDAD - 1) nivel++;
+        nivel_anterior = nivel;
+
+        UBaseType_t prioridad = PRIORIDAD_CONTROLADOR - 1 - nivel;
+
+        // Se omiten las tareas que conservan su nivel.
+        if (tarea->prioridad == prioridad) continue;
+
+        vTaskPrioritySet(tarea->handle, prioridad);
+        tarea->prioridad = prioridad;
+    }
+
+    // Reinicio de la prioridad de las tareas que han terminado su trabajo.
+    for (int i = planificables; i < total_tareas; i++)
+    {
+        if (tareas[i]->prioridad == PRIORIDAD_BASE) continue;
+
+        vTaskPrioritySet(tareas[i]->handle, PRIORIDAD_BASE);
+        tareas[i]->prioridad = PRIORIDAD_BASE;
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:     Indica si la tarea de una posición del registro está en
+ *              cabeza de algún núcleo tras la última pasada.
+ *
+ * Autor:       Juan Misael Sánchez Pacheco
+ * Fecha:       17 de octubre de 2026
+ * Versión:     1.0
+ */
+static bool estaEnCabeza(int posicion)
+{
+    for (int n = 0; n < NUCLEOS_LLF; n++)
+        if (posiciones_cabeza[n] == posicion) return true;
+
+    return false;
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:     Indica si una tarea compite por un núcleo: en el LLF
+ *              global, por cualquiera; en el particionado, solo por el
+ *              que tiene asignado.
+ *
+ * Autor:       Juan Misael Sánchez Pacheco
+ * Fecha:       17 de octubre de 2026
+ * Versión:     1.0
+ */
+static bool compiteEnNucleo(const DatosTarea *tarea, int nucleo)
+{
+    return !LLF_PARTICIONADO || tarea->nucleo == (UBaseType_t) nucleo;
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:     Utilización de una tarea (C/T) según su último trabajo,
+ *              con el plazo como separación si no tiene periodo.
+ *
+ * Autor:       Juan Misael Sánchez Pacheco
+ * Fecha:       17 de octubre de 2026
+ * Versión:     1.0
+ */
+static double calcularUtilizacion(const DatosTarea *tarea)
+{
+    TickType_t separacion = tarea->periodo > 0 ? tarea->periodo : tarea->plazo_ejecucion;
+    return separacion > 0 ? (double) tarea->ejecucion_prevista / (double) separacion : 0.0;
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:         Reparte las tareas entre los núcleos para el LLF
+ *                  particionado por empaquetado worst-fit decreasing:
+ *                  de mayor a menor utilización, cada tarea va al núcleo
+ *                  menos cargado, y se fija a él con vTaskCoreAffinitySet.
+ *
+ * Autor:           Juan Misael Sánchez Pacheco
+ * Fecha:           17 de octubre de 2026
+ * Versión:         1.0
+ * Observaciones:   Se llama desde la pasada con el planificador suspendido
+ *                  cuando cambia el registro o la carga de una tarea. Se
+ *                  prefiere worst-fit a first-fit porque equilibra la
+ *                  carga en vez de llenar primero un núcleo, y así las
+ *                  T3.x se ejecutan en paralelo. Cuesta O(n²) sin reservar
+ *                  memoria; las tareas sin trabajos aún tienen carga nula.
+ */
+static void repartirNucleos(void)
+{
+    double carga[NUCLEOS_LLF] = { 0.0 };
+    double utilizacion_anterior = 0.0;
+    int anterior = -1;
+
+    // Selección de la siguiente tarea en orden decreciente de (utilización, posición).
+    for (int k = 0; k < total_tareas; k++)
+    {
+        int elegida = -1;
+        double utilizacion_elegida = 0.0;
+
+        for (int i = 0; i < total_tareas; i++)
+        {
+            double utilizacion = calcularUtilizacion(tareas[i]);
+            bool pendiente = anterior < 0 || utilizacion < utilizacion_anterior ||
+                (utilizacion == utilizacion_anterior && i < anterior);
+            bool mayor = elegida < 0 || utilizacion > utilizacion_elegida ||
+                (utilizacion == utilizacion_elegida && i > elegida);
+
+            if (pendiente && mayor)
+            {
+                elegida = i;
+                utilizacion_elegida = utilizacion;
+            }
+        }
+
+        // Núcleo menos cargado.
+        UBaseType_t nucleo = 0;
+        for (int n = 1; n < NUCLEOS_LLF; n++)
+            if (carga[n] < carga[nucleo]) nucleo = (UBaseType_t) n;
+
+        carga[nucleo] += utilizacion_elegida;
+        anterior = elegida;
+        utilizacion_anterior = utilizacion_elegida;
+
+        DatosTarea *tarea = tareas[elegida];
+        if (tarea->nucleo == nucleo) continue;
+
+        tarea->nucleo = nucleo;
+#if NUCLEOS_LLF > 1
+        vTaskCoreAffinitySet(tarea->handle, ( UBaseType_t ) 1 << nucleo);
+#endif
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:         Cruce de LLF: calcula los ticks que faltan hasta que
+ *                  la holgura de alguna tarea activa pase a ser menor que
+ *                  la de la tarea que se va a ejecutar. Solo la tarea en
+ *                  ejecución mantiene su holgura; las demás pierden un tick
+ *                  de holgura por cada tick que esperan, por lo que el
+ *                  orden entre ellas no cambia.
+ *
+ * Autor:           Juan Misael Sánchez Pacheco
+ * Fecha:           17 de octubre de 2026
+ * Versión:         1.4
+ * Observaciones:   Debe llamarse con el planificador suspendido y tras
+ *                  recalcularPrioridades. Devuelve portMAX_DELAY
+ *                  si no hay ningún cruce posible. Con varios núcleos se
+ *                  toma el primer cruce de cualquiera de las tareas en cabeza. Con el anti-thrashing
+ *                  activo el cruce se retrasa hasta superar la histéresis
+ *                  y agotar el cuanto mínimo, pero nunca más allá del
+ *                  instante en que la siguiente tarea se queda sin holgura,
+ *                  y el cruce retrasado se anota para registrarCruceAplazado.
+ */
+static TickType_t calcularSiguienteCruce(TickType_t t_actual)
+{
+    TickType_t espera_minima = portMAX_DELAY;
+    cruce_aplazado = NULL;
+
+    // Sin tarea lista en un núcleo todas sus holguras decrecen a la vez y el orden se mantiene.
+    for (int n = 0; n < NUCLEOS_LLF; n++)
+    {
+        int cabeza = posiciones_cabeza[n];
+        if (cabeza < 0) continue;
+
+        // Solo pueden adelantarla las tareas que tiene detrás y, como el registro está ordenado,
+        // la primera en hacerlo es la siguiente que espera en su núcleo. Al tick siguiente a
+        // igualarse las holguras esa tarea pasa a ser más urgente.
+        int siguiente = cabeza + 1;
+        while (siguiente < total_tareas && esPlanificable(tareas[siguiente]) &&
+               (!compiteEnNucleo(tareas[siguiente], n) || estaEnCabeza(siguiente))) siguiente++;
+        if (siguiente >= total_tareas || !esPlanificable(tareas[siguiente])) continue;
+
+        BaseType_t holgura_siguiente = tareas[siguiente]->holgura;
+        BaseType_t espera = holgura_siguiente - tareas[cabeza]->holgura + 1, cruce = espera;
+
+        // Con el anti-thrashing la siguiente tarea debe superar la histéresis y la de
+        // cabeza agotar su cuanto, pero recupera la CPU en cuanto se queda sin holgura.
+        if (NUCLEOS_LLF == 1 && (histeresis > 0 || cuanto_minimo > 0))
+        {
+            espera += (BaseType_t) histeresis;
+            TickType_t transcurrido = t_actual - inicio_cabeza;
+            if (transcurrido < cuanto_minimo && espera < (BaseType_t) (cuanto_minimo - transcurrido))
+                espera = (BaseType_t) (cuanto_minimo - transcurrido);
+
+            if (holgura_siguiente > 0 && espera > holgura_siguiente) espera = holgura_siguiente;
+            if (espera < 1) espera = 1;
+
+            // La siguiente pasada comprueba si la cabeza ha superado el cruce sin ceder la CPU.
+            if (espera > cruce)
+            {
+                cruce_aplazado = tareas[siguiente];
+                instante_cruce = t_actual + (TickType_t) cruce;
+            }
+        }
+
+        if ((TickType_t) espera < espera_minima) espera_minima = (TickType_t) espera;
+    }
+
+    return espera_minima;
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:     Cruce de las políticas EDF, RM y DM. Las claves de todas
+ *              las tareas avanzan al mismo ritmo o no cambian, así que el
+ *              orden solo varía cuando una tarea se activa o termina.
+ *
+ * Autor:       Juan Misael Sánchez Pacheco
+ * Fecha:       17 de octubre de 2026
+ * Versión:     1.0
+ */
+static TickType_t calcularCruceEstatico(TickType_t t_actual)
+{
+    ( void ) t_actual;
+    return portMAX_DELAY;
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:         Cruce de EDZL: el primer instante en que una tarea
+ *                  que espera se queda sin holgura y pasa delante de las
+ *                  demás. Las tareas que esperan pierden un tick de
+ *                  holgura por tick, y las que se ejecutan la conservan.
+ *
+ * Autor:           Juan Misael Sánchez Pacheco
+ * Fecha:           17 de octubre de 2026
+ * Versión:         1.1
+ * Observaciones:   Debe llamarse con el planificador suspendido y tras
+ *                  recalcularPrioridades.
+ */
+static TickType_t calcularCruceEDZL(TickType_t t_actual)
+{
+    ( void ) t_actual;
+    TickType_t espera = portMAX_DELAY;
+
+    for (int i = 0; i < total_tareas && esPlanificable(tareas[i]); i++)
+    {
+        if (estaEnCabeza(i) || tareas[i]->holgura <= 0) continue;
+        if ((TickType_t) tareas[i]->holgura < espera) espera = (TickType_t) tareas[i]->holgura;
+    }
+
+    return espera;
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:     Ticks que faltan desde t_actual hasta el plazo absoluto
+ *              de un trabajo. Es negativo si el plazo ya ha vencido.
+ *
+ * Autor:       Juan Misael Sánchez Pacheco
+ * Fecha:       17 de octubre de 2026
+ * Versión:     1.0
+ */
+static BaseType_t calcularTiempoHastaPlazo(TickType_t instante_activacion, TickType_t plazo, TickType_t t_actual)
+{
+    // La resta sin signo interpretada con signo es correcta aunque el contador de ticks desborde.
+    return (BaseType_t) (int32_t) (instante_activacion + plazo - t_actual);
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:     Indica si una tarea forma parte de una solicitud de admisión.
+ *
+ * Autor:       Juan Misael Sánchez Pacheco
+ * Fecha:       17 de octubre de 2026
+ * Versión:     1.0
+ */
+static bool esCandidata(const SolicitudAdmision *solicitud, const DatosTarea *tarea)
+{
+    for (int i = 0; i < solicitud->total_candidatas; i++)
+        if (solicitud->candidatas[i] == tarea) return true;
+
+    return false;
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:         Prueba de utilización: la suma de C/T de las tareas
+ *                  con periodo no supera la capacidad de los núcleos.
+ *
+ * Autor:           Juan Misael Sánchez Pacheco
+ * Fecha:           17 de octubre de 2026
+ * Versión:         1.1
+ * Observaciones:   De las tareas registradas se toma el tiempo previsto de
+ *                  su último trabajo; las que aún no han tenido ninguno no
+ *                  cuentan. Las candidatas cuentan con el de la solicitud
+ *                  y, si no tienen periodo, con su plazo como separación.
+ *                  Con varios núcleos es una condición necesaria, no
+ *                  suficiente: no tiene en cuenta cómo se reparte la carga.
+ */
+static bool superaTestUtilizacion(const SolicitudAdmision *solicitud)
+{
+    double utilizacion = 0.0;
+
+    for (int i = 0; i < total_tareas; i++)
+    {
+        const DatosTarea *tarea = tareas[i];
+        if (tarea->periodo == 0 || esCandidata(solicitud, tarea)) continue;
+
+        utilizacion += (double) tarea->ejecucion_prevista / (double) tarea->periodo;
+    }
+
+    for (int i = 0; i < solicitud->total_candidatas; i++)
+    {
+        const DatosTarea *candidata = solicitud->candidatas[i];
+        TickType_t separacion = candidata->periodo > 0 ? candidata->periodo : candidata->plazo_ejecucion;
+
+        utilizacion += (double) solicitud->ejecucion / (double) separacion;
+    }
+
+    return utilizacion <= (double) NUCLEOS_LLF;
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:         Demanda de procesador, en ticks, de los trabajos cuyo
+ *                  plazo vence como tarde dentro de limite ticks: lo que
+ *                  les queda a los trabajos activos, los trabajos de las
+ *                  candidatas y las próximas activaciones de las tareas
+ *                  periódicas.
+ *
+ * Autor:           Juan Misael Sánchez Pacheco
+ * Fecha:           17 de octubre de 2026
+ * Versión:         1.0
+ */
+static TickType_t calcularDemanda(const SolicitudAdmision *solicitud, TickType_t t_actual, BaseType_t limite)
+{
+    TickType_t demanda = 0;
+
+    for (int i = 0; i < total_tareas; i++)
+    {
+        const DatosTarea *tarea = tareas[i];
+        if (esCandidata(solicitud, tarea)) continue;
+
+        // Trabajo activo. Los que ya han vencido siguen ocupando la CPU.
+        if (esPlanificable(tarea) &&
+            calcularTiempoHastaPlazo(tarea->instante_activacion, tarea->plazo_ejecucion, t_actual) <= limite)
+            demanda += tarea->ejecucion_restante;
+
+        // Próximas activaciones de las tareas periódicas que ya han tenido algún trabajo.
+        if (tarea->periodo == 0 || tarea->ejecucion_prevista == 0) continue;
+
+        BaseType_t activacion = calcularTiempoHastaPlazo(tarea->instante_activacion, tarea->periodo, t_actual);
+        if (activacion < 0) activacion = 0;
+
+        for ( ; activacion + (BaseType_t) tarea->plazo_ejecucion <= limite; activacion += tarea->periodo)
+            demanda += tarea->ejecucion_prevista;
+    }
+
+    for (int i = 0; i < solicitud->total_candidatas; i++)
+    {
+        if (calcularTiempoHastaPlazo(solicitud->instante_activacion, solicitud->candidatas[i]->plazo_ejecucion, t_actual) <= limite)
+            demanda += solicitud->ejecucion;
+    }
+
+    return demanda;
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:         Prueba de demanda de procesador: en cada plazo
+ *                  pendiente hasta el de la candidata más lejana, la
+ *                  demanda que vence antes no supera el tiempo disponible
+ *                  en todos los núcleos.
+ *
+ * Autor:           Juan Misael Sánchez Pacheco
+ * Fecha:           17 de octubre de 2026
+ * Versión:         1.1
+ * Observaciones:   Cuesta O(n²) sobre el registro, que es pequeño. Más
+ *                  allá del horizonte la carga periódica la cubre la
+ *                  prueba de utilización. Como esta, con varios núcleos
+ *                  solo es una condición necesaria.
+ */
+static bool superaTestDemanda(const SolicitudAdmision *solicitud, TickType_t t_actual)
+{
+    // Horizonte: el plazo más lejano de las candidatas.
+    BaseType_t horizonte = 0;
+    for (int i = 0; i < solicitud->total_candidatas; i++)
+    {
+        BaseType_t plazo = calcularTiempoHastaPlazo(solicitud->instante_activacion, solicitud->candidatas[i]->plazo_ejecucion, t_actual);
+        if (plazo > horizonte) horizonte = plazo;
+    }
+
+    // Basta comprobar la demanda en los plazos dentro del horizonte, donde crece.
+    for (int i = 0; i < solicitud->total_candidatas; i++)
+    {
+        BaseType_t plazo = calcularTiempoHastaPlazo(solicitud->instante_activacion, solicitud->candidatas[i]->plazo_ejecucion, t_actual);
+        if (plazo >= 0 && calcularDemanda(solicitud, t_actual, plazo) > (TickType_t) plazo * NUCLEOS_LLF) return false;
+    }
+
+    for (int i = 0; i < total_tareas; i++)
+    {
+        const DatosTarea *tarea = tareas[i];
+        if (esCandidata(solicitud, tarea)) continue;
+
+        BaseType_t plazo = calcularTiempoHastaPlazo(tarea->instante_activacion, tarea->plazo_ejecucion, t_actual);
+        if (esPlanificable(tarea) && plazo >= 0 && plazo <= horizonte &&
+            calcularDemanda(solicitud, t_actual, plazo) > (TickType_t) plazo * NUCLEOS_LLF) return false;
+
+        if (tarea->periodo == 0 || tarea->ejecucion_prevista == 0) continue;
+
+        BaseType_t activacion = calcularTiempoHastaPlazo(tarea->instante_activacion, tarea->periodo, t_actual);
+        if (activacion < 0) activacion = 0;
+
+        for (plazo = activacion + (BaseType_t) tarea->plazo_ejecucion; plazo <= horizonte; plazo += tarea->periodo)
+            if (calcularDemanda(solicitud, t_actual, plazo) > (TickType_t) plazo * NUCLEOS_LLF) return false;
+    }
+
+    return true;
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:         Añade una tarea al final del registro, duplicando
+ *                  su capacidad y la de su espacio auxiliar si está lleno.
+ *
+ * Autor:           Juan Misael Sánchez Pacheco
+ * Fecha:           17 de octubre de 2026
+ * Versión:         1.1
+ * Observaciones:   Las tareas nuevas están inactivas, así que el final
+ *                  del registro es su puesto en el orden por holgura.
+ *                  El registro se modifica con el planificador suspendido
+ *                  para que el LLF nunca lo vea a medio modificar.
+ */
+static bool registrarTarea(DatosTarea *datos)
+{
+    bool registrada = false;
+    DatosTarea **ampliado = NULL, **anterior = NULL, **ampliado_auxiliar = NULL, **anterior_auxiliar = NULL;
+    int capacidad = capacidad_tareas > 0 ? capacidad_tareas * 2 : CAPACIDAD_INICIAL;
+
+    // La reserva para ampliar el registro y su espacio auxiliar se hace fuera
+    // de la sección suspendida.
+    if (total_tareas >= capacidad_tareas)
+    {
+        ampliado = pvPortMalloc(capacidad * sizeof(DatosTarea *));
+        ampliado_auxiliar = pvPortMalloc(capacidad * sizeof(DatosTarea *));
+    }
+
+    vTaskSuspendAll();
+    {
+        // Otra tarea puede haber ampliado el registro mientras tanto.
+        if (total_tareas == capacidad_tareas && ampliado != NULL && ampliado_auxiliar != NULL &&
+            capacidad > capacidad_tareas)
+        {
+            if (total_tareas > 0) memcpy(ampliado, tareas, total_tareas * sizeof(DatosTarea *));
+            anterior = tareas;
+            anterior_auxiliar = auxiliar;
+            tareas = ampliado;
+            auxiliar = ampliado_auxiliar;
+            capacidad_tareas = capacidad;
+            ampliado = NULL;
+            ampliado_auxiliar = NULL;
+        }
+
+        if (total_tareas < capacidad_tareas)
+        {
+            tareas[total_tareas++] = datos;
+            atomic_store_explicit(&reparto_pendiente, true, memory_order_relaxed);
+            registrada = true;
+        }
+    }
+    xTaskResumeAll();
+
+    // Liberación del registro sustituido o de la reserva que no se ha usado.
+    if (anterior != NULL) vPortFree(anterior);
+    if (anterior_auxiliar != NULL) vPortFree(anterior_auxiliar);
+    if (ampliado != NULL) vPortFree(ampliado);
+    if (ampliado_auxiliar != NULL) vPortFree(ampliado_auxiliar);
+
+    return registrada;
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:     Retira una tarea del registro conservando el
+ *              orden por holgura del resto.
+ *
+ * Autor:       Juan Misael Sánchez Pacheco
+ * Fecha:       17 de octubre de 2026
+ * Versión:     1.2
+ */
+static void desregistrarTarea(DatosTarea *datos)
+{
+    vTaskSuspendAll();
+    {
+        // El anti-thrashing no puede seguir reteniendo una tarea que ya no existe.
+        if (tarea_en_cabeza == datos) tarea_en_cabeza = NULL;
+        if (cruce_aplazado == datos) cruce_aplazado = NULL;
+        if (aspirante_retenido == datos) aspirante_retenido = NULL;
+
+        for (int i = 0; i < total_tareas; i++)
+        {
+            if (tareas[i] != datos) continue;
+
+            memmove(&tareas[i], &tareas[i + 1], (total_tareas - i - 1) * sizeof(DatosTarea *));
+            total_tareas--;
+            atomic_store_explicit(&reparto_pendiente, true, memory_order_relaxed);
+            break;
+        }
+    }
+    xTaskResumeAll();
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:     Deja los datos de una tarea eliminada pendientes de
+ *              que la tarea idle los libere.
+ *
+ * Autor:       Juan Misael Sánchez Pacheco
+ * Fecha:       17 de octubre de 2026
+ * Versión:     1.0
+ */
+static void aplazarLiberacion(DatosTarea *datos)
+{
+    vTaskSuspendAll();
+    {
+        datos->siguiente_eliminada = tareas_eliminadas;
+        tareas_eliminadas = datos;
+    }
+    xTaskResumeAll();
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:     Avisa al planificador LLF de que una tarea se ha
+ *              activado o ha terminado para que recalcule las
+ *              prioridades sin esperar a su siguiente periodo.
+ *
+ * Autor:       Juan Misael Sánchez Pacheco
+ * Fecha:       17 de octubre de 2026
+ * Versión:     1.0
+ */
+void notificarLLF(void)
+{
+#if LLF_MODO_EVENTOS
+    if (tarea_LLF != NULL) xTaskNotifyGive(tarea_LLF);
+#endif
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:         Suma al tiempo de CPU consumido por la tarea saliente
+ *                  el tiempo transcurrido desde la salida anterior de su
+ *                  núcleo, que es cuando entró en ejecución, y cuenta los
+ *                  cambios de contexto.
+ *
+ * Autor:           Juan Misael Sánchez Pacheco
+ * Fecha:           17 de octubre de 2026
+ * Versión:         1.2
+ * Observaciones:   Se invoca desde traceTASK_SWITCHED_OUT dentro del cambio
+ *                  de contexto, por lo que no puede bloquearse. El kernel
+ *                  elige la tarea entrante justo después, así que basta este
+ *                  hook y traceTASK_SWITCHED_IN queda libre para el grabador
+ *                  de trazas (ver FreeRTOSConfig.h). Recibe la tarea
+ *                  saliente y su etiqueta, que es NULL para la tarea idle,
+ *                  la de temporizadores y el propio LLF. Cada núcleo mide
+ *                  la ejecución de la tarea que saca de su CPU.
+ */
+void registrarSalidaTarea(void *pxCurrentTCB, void *etiqueta)
+{
+    DatosTarea *saliente = (DatosTarea *) etiqueta;
+    int nucleo = NUCLEO_ACTUAL();
+    uint32_t ahora = (uint32_t) ulGetRunTimeCounterValue();
+
+    // El kernel invoca el hook aunque vuelva a elegir la misma tarea: hubo cambio
+    // de contexto si la tarea saliente no es la que salió la vez anterior.
+    if ((TaskHandle_t) pxCurrentTCB != tarea_ejecutada[nucleo]) estadisticas.cambios_contexto++;
+    tarea_ejecutada[nucleo] = (TaskHandle_t) pxCurrentTCB;
+
+    // La resta sin signo es correcta aunque el contador haya desbordado.
+    if (saliente != NULL) saliente->ejecucion_consumida += ahora - inicio_ejecucion[nucleo];
+    inicio_ejecucion[nucleo] = ahora;
+}
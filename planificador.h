@@ -0,0 +1,197 @@
+/*
+ * FreeRTOS V202112.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+#ifndef PLANIFICADOR_H
+    #define PLANIFICADOR_H
+
+    #include <stdbool.h>
+    #include <stdatomic.h>
+
+    #include "FreeRTOS.h"
+    #include "task.h"
+
+    #ifdef __cplusplus
+        extern "C" {
+    #endif
+
+/*-----------------------------------------------------------
+* Planificador LLF (Least Laxity First) y registro de tareas.
+*----------------------------------------------------------*/
+
+    // Prioridad base para todas las tareas.
+    #define PRIORIDAD_BASE 1
+
+    // Prioridad máxima para el planificador LLF.
+    #define PRIORIDAD_CONTROLADOR ( configMAX_PRIORITIES - 1 )
+
+    // Niveles de prioridad que el LLF reparte entre las tareas activas.
+    #define NIVELES_PRIORIDAD ( PRIORIDAD_CONTROLADOR - PRIORIDAD_BASE - 1 )
+
+    // Políticas con las que el controlador puede ordenar las tareas.
+    typedef enum {
+
+        POLITICA_LLF, // Least Laxity First: menor holgura.
+        POLITICA_EDF, // Earliest Deadline First: plazo absoluto más próximo.
+        POLITICA_RM, // Rate Monotonic: menor periodo.
+        POLITICA_DM, // Deadline Monotonic: menor plazo relativo.
+        POLITICA_EDZL, // EDF con prioridad absoluta para las tareas con holgura nula.
+        TOTAL_POLITICAS
+
+    } PoliticaPlanificacion;
+
+    // Medida que se toma cuando un trabajo agota su presupuesto de ejecución o
+    // su plazo vence antes de terminar.
+    typedef enum {
+
+        SOBRECOSTE_NINGUNO, // Solo se registra: el trabajo sigue como hasta ahora.
+        SOBRECOSTE_ABORTAR, // Se pide a la tarea que abandone el trabajo y pasa a segundo plano.
+        SOBRECOSTE_OMITIR_SIGUIENTE, // El trabajo sigue, pero se omite la siguiente activación.
+        SOBRECOSTE_DEGRADAR // El resto del trabajo se ejecuta en segundo plano (PRIORIDAD_BASE).
+
+    } PoliticaSobrecoste;
+
+    // Decisión del control de admisión sobre un trabajo esporádico.
+    typedef enum {
+
+        ADMISION_ADMITIDA, // El conjunto de trabajos sigue siendo planificable.
+        ADMISION_APLAZADA, // Ahora no cabe, pero aún puede cumplir su plazo si se activa más tarde.
+        ADMISION_RECHAZADA // No puede cumplir su plazo o sobrecargaría la CPU de forma permanente.
+
+    } ResultadoAdmision;
+
+    // Estructura para agrupar los datos de cada tarea necesarios
+    // para la planificación LLF. Solo la propia tarea modifica los datos de su
+    // trabajo y los publica con iniciarTrabajoLLF y finalizarTrabajoLLF.
+    typedef struct DatosTarea {
+
+        TaskHandle_t handle; // Handle de cada tarea.
+        TickType_t instante_activacion; // Instante de activación de cada tarea.
+        TickType_t plazo_ejecucion; // Plazo de ejecución de cada tarea.
+        TickType_t periodo; // Periodo o separación mínima entre activaciones (0 si no se conoce).
+        TickType_t ejecucion_prevista; // Tiempo de ejecución previsto (C) del trabajo actual.
+        uint32_t ejecucion_consumida; // Tiempo de CPU consumido por el trabajo actual, en microsegundos.
+        TickType_t ejecucion_restante; // Tiempo de ejecución restante por completar.
+        BaseType_t holgura; // Holgura actual de la tarea. Es negativa si ya no puede cumplir su plazo.
+        BaseType_t clave; // Clave de orden de la política activa: menor clave, mayor prioridad.
+        UBaseType_t prioridad; // Última prioridad asignada a la tarea.
+        UBaseType_t nucleo; // Núcleo asignado a la tarea en el LLF particionado.
+        bool retenida; // El anti-thrashing ha retrasado a la tarea en su trabajo actual.
+        uint32_t plazos_perdidos; // Trabajos terminados después de su plazo.
+        uint32_t sobrecostes; // Trabajos que han agotado su presupuesto de ejecución.
+        uint32_t activaciones_omitidas; // Activaciones omitidas por la política de sobrecoste.
+        PoliticaSobrecoste politica_sobrecoste; // Medida ante un sobrecoste o un plazo vencido.
+        TickType_t margen_sobrecoste; // Ejecución tolerada por encima de la prevista antes del sobrecoste.
+        bool sobrecoste; // El LLF ha detectado que el trabajo actual agotó su presupuesto.
+        bool plazo_vencido; // El LLF ha detectado que el plazo del trabajo actual venció.
+        bool degradada; // El trabajo actual se ejecuta en segundo plano por la política de sobrecoste.
+        atomic_bool abortar; // El LLF pide a la tarea que abandone el trabajo actual.
+        atomic_bool omitir_siguiente; // El LLF pide a la tarea que omita su siguiente activación.
+        TickType_t proxima_activacion; // Próxima activación periódica, anunciada por esperarActivacionLLF.
+        atomic_bool esperando_activacion; // La tarea está bloqueada hasta proxima_activacion.
+        atomic_bool activa; // Indicativo de activación de la tarea.
+        struct DatosTarea *siguiente_eliminada; // Siguiente tarea eliminada pendiente de liberar.
+
+    } DatosTarea;
+
+    // Contadores del planificador desde su inicio.
+    typedef struct {
+
+        uint32_t cambios_contexto; // Cambios de contexto entre tareas distintas.
+        uint32_t pasadas_controlador; // Activaciones del controlador.
+        uint32_t tiempo_controlador; // Tiempo de CPU de las pasadas del controlador, en microsegundos.
+        uint32_t plazos_perdidos; // Trabajos de las tareas registradas terminados después de su plazo.
+        uint32_t sobrecostes; // Trabajos que han agotado su presupuesto de ejecución.
+        uint32_t activaciones_omitidas; // Activaciones omitidas por la política de sobrecoste.
+        uint32_t cambios_evitados; // Cambios de contexto evitados por la histéresis o el cuanto mínimo.
+        uint32_t perdidas_introducidas; // Plazos perdidos por tareas que el anti-thrashing retrasó.
+        uint32_t trabajos_admitidos; // Solicitudes admitidas por el control de admisión.
+        uint32_t trabajos_aplazados; // Solicitudes aplazadas por el control de admisión.
+        uint32_t trabajos_rechazados; // Solicitudes rechazadas por el control de admisión.
+        uint32_t tiempo_inactivo; // Tiempo que la tarea idle ha dormido, en microsegundos.
+        uint32_t despertares; // Esperas de la tarea idle que han llegado a su fin.
+        uint32_t despertares_anticipados; // Esperas interrumpidas antes de tiempo por una señal.
+        uint32_t latencia_despertar_total; // Suma del retraso de los despertares sobre el previsto, en microsegundos.
+        uint32_t latencia_despertar_maxima; // Mayor retraso de un despertar, en microsegundos.
+
+    } EstadisticasLLF;
+
+    // Contadores de incidencias de una tarea registrada.
+    typedef struct {
+
+        const char *nombre; // Nombre de la tarea, válido mientras exista.
+        uint32_t plazos_perdidos;
+        uint32_t sobrecostes;
+        uint32_t activaciones_omitidas;
+
+    } IncidenciasTarea;
+
+    void iniciarPlanificadorLLF( void );
+    DatosTarea *crearTareaLLF( TaskFunction_t codigo,
+                               const char * nombre,
+                               TickType_t plazo,
+                               TickType_t periodo );
+    void eliminarTareaLLF( DatosTarea * datos );
+    void liberarTareasEliminadasLLF( void );
+    bool iniciarTrabajoLLF( DatosTarea * datos,
+                            TickType_t instante_activacion,
+                            TickType_t ejecucion );
+    bool iniciarTrabajoConPlazoLLF( DatosTarea * datos,
+                                    TickType_t instante_activacion,
+                                    TickType_t ejecucion,
+                                    TickType_t plazo );
+    bool trabajoAbortadoLLF( DatosTarea * datos );
+    void configurarSobrecosteLLF( DatosTarea * datos,
+                                  PoliticaSobrecoste politica,
+                                  TickType_t margen );
+    void finalizarTrabajoLLF( DatosTarea * datos );
+    void esperarActivacionLLF( DatosTarea * datos,
+                               TickType_t * activacion,
+                               TickType_t periodo );
+    TickType_t calcularEsperaInactividadLLF( void );
+    void registrarInactividadLLF( uint32_t inactivo,
+                                  uint32_t latencia,
+                                  bool anticipado );
+    void notificarLLF( void );
+    TickType_t ejecutarPasadaLLF( void );
+    void configurarAntiThrashingLLF( TickType_t histeresis,
+                                     TickType_t cuanto_minimo );
+    void obtenerEstadisticasLLF( EstadisticasLLF * estadisticas );
+    int obtenerIncidenciasLLF( IncidenciasTarea * incidencias,
+                               int capacidad );
+    void seleccionarPoliticaPlanificacion( PoliticaPlanificacion politica );
+    bool buscarPoliticaPlanificacion( const char * nombre,
+                                      PoliticaPlanificacion * politica );
+    const char *obtenerNombrePolitica( void );
+    ResultadoAdmision comprobarAdmisionLLF( DatosTarea * const * candidatas,
+                                            int total_candidatas,
+                                            TickType_t instante_activacion,
+                                            TickType_t ejecucion );
+
+    #ifdef __cplusplus
+        }
+    #endif
+
+#endif /* PLANIFICADOR_H */
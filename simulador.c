@@ -0,0 +1,1014 @@
+/*
+ * FreeRTOS V202112.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+ /***************************************************************************************
+ * Programa:            Simulador de eventos discretos del planificador.                *
+ *                                                                                      *
+ *                      Reproduce el modelo de tareas de main_base.c (T1, T2, las       *
+ *                      T3.x y T4, con los tiempos de modelo_tareas.h) en tiempo        *
+ *                      simulado y ejecuta las pasadas del controlador de               *
+ *                      planificador.c sin el kernel de FreeRTOS. El tiempo avanza      *
+ *                      de evento en evento, por lo que simula días de carga en         *
+ *                      segundos, y el resultado es siempre el mismo.                   *
+ *                                                                                      *
+ *                      Uso: simulador [ticks] [política] [histéresis] [cuanto]         *
+ *                           simulador comprobar [ticks]                                *
+ *                                                                                      *
+ *                      La segunda forma ejecuta cada caso de comprobación en un        *
+ *                      proceso hijo y termina con error si alguno falla.               *
+ *                                                                                      *
+ * Autor:               Juan Misael Sánchez Pacheco                                     *
+ * Fecha:               17 de octubre de 2026                                           *
+ * Versión:             1.2                                                             *
+ ****************************************************************************************/
+
+
+
+
+/*-----------------------------------------------------------*/
+
+
+
+
+/* BIBLIOTECAS */
+
+/* Bibliotecas utilizadas */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+/* Kernel includes. Solo se usan los tipos: el simulador implementa
+ * las funciones del kernel que necesita planificador.c. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Local includes. */
+#include "planificador.h"
+#include "modelo_tareas.h"
+
+
+
+
+/*-----------------------------------------------------------*/
+
+
+
+
+/* CONSTANTES. */
+
+// Ticks simulados si no se indican: un día.
+#define TICKS_POR_DEFECTO ( 24ULL * 60ULL * 60ULL * configTICK_RATE_HZ )
+
+// Ticks simulados en cada caso de comprobación si no se indican: una hora.
+#define TICKS_COMPROBACION ( 60ULL * 60ULL * configTICK_RATE_HZ )
+
+// Resolución del contador de tiempo de ejecución, igual que en main.c.
+#define MICROSEGUNDOS_POR_TICK ( 1000000UL / configTICK_RATE_HZ )
+
+// Tareas del modelo: T1, T2, T4 y las T3.x.
+#define TAREAS_SIMULADAS ( TAREAS_SECUNDARIAS + 3 )
+
+// Instante de un evento que no llega a producirse.
+#define NUNCA UINT64_MAX
+
+// Configuraciones del anti-thrashing (histéresis y cuanto mínimo) que se comprueban.
+#define CASOS_ANTI_THRASHING 5
+
+// Políticas de sobrecoste de T4 que se comprueban y ejecución que se le inyecta
+// por encima de EJECUCION_T4 para que cada trabajo agote su presupuesto.
+#define CASOS_SOBRECOSTE 4
+#define EXCESO_COMPROBACION pdMS_TO_TICKS( 300UL ) // 300 ms.
+
+
+
+
+/*-----------------------------------------------------------*/
+
+
+
+
+/* VARIABLES Y DATOS. */
+
+// Configuración de una simulación.
+typedef struct {
+
+    uint64_t ticks; // Ticks simulados.
+    const char *politica; // Nombre de la política, NULL para la de por defecto.
+    bool anti_thrashing; // Se configuran la histéresis y el cuanto mínimo.
+    TickType_t histeresis; // Histéresis del anti-thrashing.
+    TickType_t cuanto; // Cuanto mínimo del anti-thrashing.
+    PoliticaSobrecoste sobrecoste_T4; // Política de sobrecoste de T4, con margen 0.
+    TickType_t exceso_T4; // Ejecución inyectada en cada trabajo de T4 por encima de la prevista.
+
+} ConfiguracionSimulacion;
+
+// Resultado de una tarea del modelo en una simulación.
+typedef struct {
+
+    uint32_t trabajos; // Trabajos terminados, también los abortados.
+    uint32_t abortados; // Trabajos abortados por la política de sobrecoste.
+    uint32_t plazos_perdidos; // Trabajos terminados después de su plazo.
+    uint32_t sobrecostes; // Trabajos que han agotado su presupuesto.
+    uint32_t activaciones_omitidas; // Activaciones omitidas por la política de sobrecoste.
+    uint32_t consumo_maximo; // Mayor ejecución consumida por un trabajo, en µs.
+
+} ResultadoTarea;
+
+// Resultado de una simulación que se ejecuta en un proceso hijo.
+typedef struct {
+
+    EstadisticasLLF estadisticas;
+    ResultadoTarea tareas[TAREAS_SIMULADAS]; // En el orden de modelo.
+
+} ResultadoSimulacion;
+
+// Bloque de control de una tarea en el simulador. Sustituye al TCB del kernel:
+// los handles que maneja planificador.c apuntan a estos bloques.
+struct tskTaskControlBlock {
+
+    char nombre[configMAX_TASK_NAME_LEN]; // Nombre de la tarea.
+    UBaseType_t prioridad; // Prioridad que le ha asignado el controlador.
+    void *etiqueta; // Etiqueta de la tarea (sus datos de planificación).
+    struct TareaSimulada *tarea; // Tarea del modelo, NULL para el controlador.
+
+};
+
+// Estado de una tarea del modelo.
+typedef struct TareaSimulada {
+
+    DatosTarea *datos; // Datos de planificación registrados en el controlador.
+    TickType_t periodo; // Periodo de las tareas periódicas, 0 para las esporádicas.
+    TickType_t ejecucion; // Tiempo de ejecución de cada trabajo (C).
+    TickType_t exceso; // Ejecución de cada trabajo por encima de C, para provocar sobrecostes.
+    uint64_t siguiente_activacion; // Próxima activación de las tareas periódicas.
+    uint64_t activacion; // Instante de activación del trabajo actual.
+    TickType_t restante; // CPU que le queda al tramo actual del trabajo.
+    bool activa; // Tiene un trabajo en curso.
+    bool bloqueada; // Espera a otras tareas (T2 mientras trabajan las T3.x).
+    bool primer_tramo; // T2 aún no ha activado las T3.x en este trabajo.
+    int pendientes; // Activaciones esporádicas que esperan al fin del trabajo actual.
+    uint32_t trabajos; // Trabajos terminados.
+    uint32_t abortados; // Trabajos abortados por la política de sobrecoste.
+    uint32_t consumo_maximo; // Mayor ejecución consumida por un trabajo, en µs.
+    uint64_t respuesta_maxima; // Peor tiempo de respuesta, en ticks.
+
+} TareaSimulada;
+
+// Tareas del modelo. Las T3.x ocupan las últimas posiciones.
+static TareaSimulada modelo[TAREAS_SIMULADAS];
+static TareaSimulada *const T1 = &modelo[0], *const T2 = &modelo[1], *const T4 = &modelo[2];
+static TareaSimulada *const T3x = &modelo[3];
+
+// T3.x de la ronda actual de T2 que aún no han terminado.
+static int respuestas_pendientes = 0;
+
+// Tiempo simulado, en ticks.
+static uint64_t ahora = 0;
+
+// Controlador, tarea inactiva y tarea que ocupa la CPU.
+static TaskHandle_t controlador = NULL;
+static struct tskTaskControlBlock tcb_inactiva = { "IDLE", 0, NULL, NULL };
+static TaskHandle_t handle_en_ejecucion = &tcb_inactiva;
+static TareaSimulada *en_ejecucion = NULL;
+
+// Instante en que empezó la rodaja de tiempo de la tarea en ejecución.
+static uint64_t inicio_rodaja = 0;
+
+// Activación pendiente del controlador e instante en que vence su espera.
+static bool pasada_pendiente = true;
+static uint64_t despertar_controlador = NUNCA;
+
+
+
+
+/*-----------------------------------------------------------*/
+
+
+
+
+// PROTOTIPOS DE FUNCIONES.
+
+// Simulación.
+static bool configurarSimulacion(const ConfiguracionSimulacion *);
+static void crearModelo(void);
+static void simular(uint64_t);
+static void ejecutarControlador(void);
+static TareaSimulada *elegirTarea(bool *);
+static void conmutarA(TaskHandle_t);
+static void activarTrabajo(TareaSimulada *, uint64_t);
+static void completarTramo(TareaSimulada *);
+static void terminarTrabajo(TareaSimulada *);
+static void imprimirInforme(uint64_t);
+
+// Comprobaciones.
+static int comprobarSimulaciones(uint64_t);
+static bool simularEnHijo(const ConfiguracionSimulacion *, ResultadoSimulacion *);
+static bool comprobarAntiThrashing(uint64_t);
+static bool comprobarSobrecostes(uint64_t);
+
+// Código de las tareas creadas en el controlador, que nunca se ejecuta.
+static void xTareaSimulada( void * pvParameters );
+
+
+
+
+/*-----------------------------------------------------------*/
+
+
+
+
+/*
+ * Rutina principal.
+ */
+int main(int argc, char *argv[])
+{
+    if (argc > 1 && strcmp(argv[1], "comprobar") == 0)
+        return comprobarSimulaciones(argc > 2 ? strtoull(argv[2], NULL, 10) : TICKS_COMPROBACION);
+
+    ConfiguracionSimulacion configuracion = {
+        .ticks = argc > 1 ? strtoull(argv[1], NULL, 10) : TICKS_POR_DEFECTO,
+        .politica = argc > 2 ? argv[2] : NULL,
+        .anti_thrashing = argc > 3,
+        .histeresis = argc > 3 ? (TickType_t) strtoul(argv[3], NULL, 10) : 0,
+        .cuanto = argc > 4 ? (TickType_t) strtoul(argv[4], NULL, 10) : 0
+    };
+
+    if (!configurarSimulacion(&configuracion)) return EXIT_FAILURE;
+
+    // El tiempo real solo se informa por stderr para que la salida sea determinista.
+    clock_t inicio = clock();
+    simular(configuracion.ticks);
+    double segundos = (double) (clock() - inicio) / CLOCKS_PER_SEC;
+
+    imprimirInforme(configuracion.ticks);
+    fprintf(stderr, "%.2f s de CPU, %.0f ticks simulados por segundo\n",
+        segundos, segundos > 0.0 ? (double) configuracion.ticks / segundos : 0.0);
+
+    return EXIT_SUCCESS;
+}
+
+
+
+
+/*-----------------------------------------------------------*/
+
+
+
+
+/*
+ * Función:         Inicia el controlador con la política y el
+ *                  anti-thrashing de la configuración, crea las tareas
+ *                  del modelo y aplica a T4 la política de sobrecoste y
+ *                  la ejecución inyectada.
+ *
+ * Autor:           Juan Misael Sánchez Pacheco
+ * Fecha:           17 de octubre de 2026
+ * Versión:         1.1
+ * Observaciones:   Devuelve false si la política no existe.
+ */
+static bool configurarSimulacion(const ConfiguracionSimulacion *configuracion)
+{
+    // La tarea del controlador es la primera que se crea.
+    iniciarPlanificadorLLF();
+
+    if (configuracion->politica != NULL)
+    {
+        PoliticaPlanificacion politica;
+        if (!buscarPoliticaPlanificacion(configuracion->politica, &politica))
+        {
+            fprintf(stderr, "Política desconocida: %s\n", configuracion->politica);
+            return false;
+        }
+        seleccionarPoliticaPlanificacion(politica);
+    }
+
+    if (configuracion->anti_thrashing) configurarAntiThrashingLLF(configuracion->histeresis, configuracion->cuanto);
+
+    crearModelo();
+
+    configurarSobrecosteLLF(T4->datos, configuracion->sobrecoste_T4, 0);
+    T4->exceso = configuracion->exceso_T4;
+
+    return true;
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:     Registra en el controlador las tareas del modelo con los
+ *              mismos plazos y periodos que main_base.c.
+ *
+ * Autor:       Juan Misael Sánchez Pacheco
+ * Fecha:       17 de octubre de 2026
+ * Versión:     1.0
+ */
+static void crearModelo(void)
+{
+    T1->datos = crearTareaLLF( xTareaSimulada, "T1", PLAZO_T1, PERIODO_T1 );
+    T1->periodo = PERIODO_T1;
+    T1->ejecucion = EJECUCION_T1;
+
+    T2->datos = crearTareaLLF( xTareaSimulada, "T2", PLAZO_T2, PERIODO_T1 );
+    T2->ejecucion = EJECUCION_T2;
+
+    T4->datos = crearTareaLLF( xTareaSimulada, "T4", PLAZO_T4, PERIODO_T4 );
+    T4->periodo = PERIODO_T4;
+    T4->ejecucion = EJECUCION_T4;
+
+    for (int i = 0; i < TAREAS_SECUNDARIAS; i++)
+    {
+        char nombre_tarea[configMAX_TASK_NAME_LEN];
+        snprintf(nombre_tarea, sizeof(nombre_tarea), "T3.%d", i + 1);
+
+        T3x[i].datos = crearTareaLLF( xTareaSimulada, nombre_tarea, PLAZO_T3x, PERIODO_T1 );
+        T3x[i].ejecucion = EJECUCION_T3x;
+    }
+
+    for (int i = 0; i < TAREAS_SIMULADAS; i++)
+    {
+        if (modelo[i].datos == NULL)
+        {
+            fprintf(stderr, "No hay memoria para las tareas del modelo\n");
+            exit(EXIT_FAILURE);
+        }
+
+        modelo[i].datos->handle->tarea = &modelo[i];
+        modelo[i].siguiente_activacion = modelo[i].periodo > 0 ? 0 : NUNCA;
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:         Avanza el tiempo simulado de evento en evento hasta
+ *                  el tick indicado. Los eventos son las activaciones
+ *                  periódicas, el fin de un tramo de ejecución y el fin de
+ *                  la espera del controlador; si varias tareas comparten
+ *                  la prioridad más alta se avanza tick a tick para
+ *                  repartir la CPU por turnos, como FreeRTOS.
+ *
+ * Autor:           Juan Misael Sánchez Pacheco
+ * Fecha:           17 de octubre de 2026
+ * Versión:         1.1
+ * Observaciones:   El controlador se ejecuta sin consumir tiempo simulado
+ *                  y las activaciones esporádicas se producen en el mismo
+ *                  instante en que se envía el mensaje que las provoca.
+ */
+static void simular(uint64_t fin)
+{
+    while (ahora < fin)
+    {
+        // Activaciones periódicas. Una tarea con retraso empieza el trabajo siguiente al terminar.
+        for (int i = 0; i < TAREAS_SIMULADAS; i++)
+        {
+            TareaSimulada *tarea = &modelo[i];
+            if (tarea->activa || tarea->siguiente_activacion > ahora) continue;
+
+            activarTrabajo(tarea, tarea->siguiente_activacion);
+            tarea->siguiente_activacion += tarea->periodo;
+        }
+
+        // El controlador atiende las activaciones y finalizaciones o el fin de su espera.
+        if (pasada_pendiente || ahora >= despertar_controlador) ejecutarControlador();
+
+        // Tarea que ocupa la CPU según las prioridades del controlador.
+        bool turnos = false;
+        TareaSimulada *elegida = elegirTarea(&turnos);
+
+        // Una tarea a la que el controlador ha pedido abortar su trabajo lo deja en
+        // cuanto vuelve a tener la CPU, como T4 en su espera activa.
+        if (elegida != NULL && trabajoAbortadoLLF(elegida->datos))
+        {
+            elegida->abortados++;
+            terminarTrabajo(elegida);
+            continue;
+        }
+
+        conmutarA(elegida != NULL ? elegida->datos->handle : &tcb_inactiva);
+
+        // Siguiente evento.
+        uint64_t siguiente = fin;
+        if (despertar_controlador < siguiente) siguiente = despertar_controlador;
+        for (int i = 0; i < TAREAS_SIMULADAS; i++)
+        {
+            if (!modelo[i].activa && modelo[i].siguiente_activacion < siguiente)
+                siguiente = modelo[i].siguiente_activacion;
+        }
+        if (elegida != NULL && ahora + elegida->restante < siguiente) siguiente = ahora + elegida->restante;
+        if (turnos && ahora + 1 < siguiente) siguiente = ahora + 1;
+
+        // Avance del tiempo con la tarea elegida en la CPU.
+        if (elegida != NULL) elegida->restante -= (TickType_t) (siguiente - ahora);
+        ahora = siguiente;
+
+        if (elegida != NULL && elegida->restante == 0) completarTramo(elegida);
+    }
+
+    // Se contabiliza la ejecución del último tramo.
+    conmutarA(&tcb_inactiva);
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:     Ejecuta una pasada del controlador y programa la siguiente
+ *              según la espera que devuelve.
+ *
+ * Autor:       Juan Misael Sánchez Pacheco
+ * Fecha:       17 de octubre de 2026
+ * Versión:     1.0
+ */
+static void ejecutarControlador(void)
+{
+    // El controlador expulsa a la tarea en ejecución, como en el sistema real.
+    conmutarA(controlador);
+
+    TickType_t espera = ejecutarPasadaLLF();
+    pasada_pendiente = false;
+
+    if (espera == portMAX_DELAY) despertar_controlador = NUNCA;
+    else despertar_controlador = ahora + (espera > 0 ? espera : 1);
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:         Elige la tarea lista de mayor prioridad. Si varias
+ *                  comparten esa prioridad, se turnan en cada tick.
+ *
+ * Autor:           Juan Misael Sánchez Pacheco
+ * Fecha:           17 de octubre de 2026
+ * Versión:         1.0
+ * Observaciones:   Indica en turnos si hay más de una candidata.
+ */
+static TareaSimulada *elegirTarea(bool *turnos)
+{
+    UBaseType_t maxima = 0;
+    int candidatas = 0;
+
+    for (int i = 0; i < TAREAS_SIMULADAS; i++)
+    {
+        if (!modelo[i].activa || modelo[i].bloqueada) continue;
+
+        UBaseType_t prioridad = modelo[i].datos->handle->prioridad;
+        if (candidatas == 0 || prioridad > maxima)
+        {
+            maxima = prioridad;
+            candidatas = 1;
+        }
+        else if (prioridad == maxima)
+        {
+            candidatas++;
+        }
+    }
+
+    *turnos = candidatas > 1;
+    if (candidatas == 0) return NULL;
+
+    // La tarea en ejecución conserva la CPU hasta agotar su rodaja de un tick.
+    if (en_ejecucion != NULL && en_ejecucion->activa && !en_ejecucion->bloqueada &&
+        en_ejecucion->datos->handle->prioridad == maxima && ahora == inicio_rodaja)
+        return en_ejecucion;
+
+    // Turno rotatorio a partir de la última tarea ejecutada.
+    int inicio = en_ejecucion != NULL ? (int) (en_ejecucion - modelo) + 1 : 0;
+    for (int k = 0; k < TAREAS_SIMULADAS; k++)
+    {
+        TareaSimulada *tarea = &modelo[(inicio + k) % TAREAS_SIMULADAS];
+        if (tarea->activa && !tarea->bloqueada && tarea->datos->handle->prioridad == maxima)
+            return tarea;
+    }
+
+    return NULL;
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:         Cambia la tarea que ocupa la CPU invocando el mismo
+ *                  hook que el kernel (ver FreeRTOSConfig.h), de modo que
+ *                  el controlador contabiliza la ejecución como en el
+ *                  sistema real.
+ *
+ * Autor:           Juan Misael Sánchez Pacheco
+ * Fecha:           17 de octubre de 2026
+ * Versión:         1.1
+ */
+static void conmutarA(TaskHandle_t handle)
+{
+    if (handle == handle_en_ejecucion) return;
+
+    registrarSalidaTarea(handle_en_ejecucion, handle_en_ejecucion->etiqueta);
+
+    handle_en_ejecucion = handle;
+    en_ejecucion = handle->tarea;
+    inicio_rodaja = ahora;
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:         Activa un trabajo de una tarea del modelo o, si la
+ *                  tarea aún tiene uno en curso, lo deja pendiente.
+ *
+ * Autor:           Juan Misael Sánchez Pacheco
+ * Fecha:           17 de octubre de 2026
+ * Versión:         1.1
+ * Observaciones:   T2 se ejecuta en dos tramos: el primero termina al
+ *                  activar las T3.x y el segundo al recibir sus resultados.
+ *                  Al controlador se le anuncia la ejecución prevista,
+ *                  sin el exceso inyectado.
+ */
+static void activarTrabajo(TareaSimulada *tarea, uint64_t instante)
+{
+    if (tarea->activa)
+    {
+        tarea->pendientes++;
+        return;
+    }
+
+    // La política de sobrecoste puede omitir la activación.
+    if (!iniciarTrabajoLLF(tarea->datos, (TickType_t) instante, tarea->ejecucion)) return;
+
+    tarea->activa = true;
+    tarea->bloqueada = false;
+    tarea->activacion = instante;
+    tarea->primer_tramo = tarea == T2;
+    tarea->restante = tarea == T2 ? tarea->ejecucion / 2 : tarea->ejecucion + tarea->exceso;
+    pasada_pendiente = true;
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:     Procesa el fin del tramo de ejecución de una tarea:
+ *              los mensajes que envía y el fin de su trabajo.
+ *
+ * Autor:       Juan Misael Sánchez Pacheco
+ * Fecha:       17 de octubre de 2026
+ * Versión:     1.1
+ */
+static void completarTramo(TareaSimulada *tarea)
+{
+    // La tarea deja la CPU: se contabiliza su ejecución antes de publicar el fin.
+    conmutarA(&tcb_inactiva);
+    pasada_pendiente = true;
+
+    // T2 activa las T3.x y espera sus resultados con el resto de su ejecución.
+    if (tarea == T2 && tarea->primer_tramo)
+    {
+        tarea->primer_tramo = false;
+        tarea->bloqueada = true;
+        tarea->restante = tarea->ejecucion - tarea->ejecucion / 2;
+
+        respuestas_pendientes = TAREAS_SECUNDARIAS;
+        for (int i = 0; i < TAREAS_SECUNDARIAS; i++) activarTrabajo(&T3x[i], ahora);
+        return;
+    }
+
+    terminarTrabajo(tarea);
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:         Termina el trabajo actual de una tarea del modelo,
+ *                  completo o abortado, y envía sus mensajes.
+ *
+ * Autor:           Juan Misael Sánchez Pacheco
+ * Fecha:           17 de octubre de 2026
+ * Versión:         1.0
+ * Observaciones:   La ejecución de la tarea ya debe estar contabilizada.
+ */
+static void terminarTrabajo(TareaSimulada *tarea)
+{
+    if (tarea->datos->ejecucion_consumida > tarea->consumo_maximo)
+        tarea->consumo_maximo = tarea->datos->ejecucion_consumida;
+
+    finalizarTrabajoLLF(tarea->datos);
+    tarea->activa = false;
+    tarea->trabajos++;
+    if (ahora - tarea->activacion > tarea->respuesta_maxima) tarea->respuesta_maxima = ahora - tarea->activacion;
+
+    // T1 envía el nombre del archivo a T2; cada T3.x, su resultado.
+    if (tarea == T1) activarTrabajo(T2, ahora);
+    if (tarea >= T3x && --respuestas_pendientes == 0) T2->bloqueada = false;
+
+    // Las activaciones esporádicas pendientes empiezan en cuanto termina el trabajo.
+    if (tarea->pendientes > 0)
+    {
+        tarea->pendientes--;
+        activarTrabajo(tarea, ahora);
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:     Imprime el resultado de la simulación. Solo depende del
+ *              tiempo simulado, por lo que es reproducible.
+ *
+ * Autor:       Juan Misael Sánchez Pacheco
+ * Fecha:       17 de octubre de 2026
+ * Versión:     1.1
+ */
+static void imprimirInforme(uint64_t ticks)
+{
+    EstadisticasLLF estadisticas;
+    obtenerEstadisticasLLF(&estadisticas);
+
+    printf("Simulación de %llu ticks con la política %s\n", (unsigned long long) ticks, obtenerNombrePolitica());
+    printf("%-6s %10s %10s %12s %10s %10s %12s\n", "Tarea", "Trabajos", "Perdidos", "Sobrecostes", "Abortados",
+        "Omitidas", "Resp. máx.");
+
+    for (int i = 0; i < TAREAS_SIMULADAS; i++)
+    {
+        const TareaSimulada *tarea = &modelo[i];
+        printf("%-6s %10u %10u %12u %10u %10u %12llu\n", pcTaskGetName(tarea->datos->handle), tarea->trabajos,
+            tarea->datos->plazos_perdidos, tarea->datos->sobrecostes, tarea->abortados,
+            tarea->datos->activaciones_omitidas, (unsigned long long) tarea->respuesta_maxima);
+    }
+
+    printf("%u cambios de contexto, %u pasadas del controlador, %u cambios evitados y %u plazos perdidos por el anti-thrashing\n",
+        estadisticas.cambios_contexto, estadisticas.pasadas_controlador, estadisticas.cambios_evitados,
+        estadisticas.perdidas_introducidas);
+}
+
+
+
+
+/*-----------------------------------------------------------*/
+
+
+
+
+/*
+ * Función:         Ejecuta los casos de comprobación del controlador e
+ *                  imprime el resultado de cada uno.
+ *
+ * Autor:           Juan Misael Sánchez Pacheco
+ * Fecha:           17 de octubre de 2026
+ * Versión:         1.1
+ * Observaciones:   Devuelve el código de salida del programa:
+ *                  EXIT_FAILURE si falla alguna comprobación.
+ */
+static int comprobarSimulaciones(uint64_t ticks)
+{
+    bool correcto = comprobarAntiThrashing(ticks);
+    correcto = comprobarSobrecostes(ticks) && correcto;
+
+    printf("%s\n", correcto ? "Comprobaciones correctas" : "Comprobaciones fallidas");
+    return correcto ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:         Ejecuta una simulación en un proceso hijo, de modo que
+ *                  cada caso empieza con el controlador y el tiempo
+ *                  simulado desde cero, y recoge su resultado.
+ *
+ * Autor:           Juan Misael Sánchez Pacheco
+ * Fecha:           17 de octubre de 2026
+ * Versión:         1.1
+ * Observaciones:   Devuelve false si la simulación no ha podido terminar.
+ */
+static bool simularEnHijo(const ConfiguracionSimulacion *configuracion, ResultadoSimulacion *resultado)
+{
+    int tuberia[2];
+    if (pipe(tuberia) != 0) return false;
+
+    // La salida pendiente no debe duplicarse en el hijo.
+    fflush(stdout);
+
+    pid_t hijo = fork();
+    if (hijo == 0)
+    {
+        close(tuberia[0]);
+        if (!configurarSimulacion(configuracion)) _exit(EXIT_FAILURE);
+        simular(configuracion->ticks);
+
+        ResultadoSimulacion propio;
+        obtenerEstadisticasLLF(&propio.estadisticas);
+        for (int i = 0; i < TAREAS_SIMULADAS; i++)
+        {
+            const TareaSimulada *tarea = &modelo[i];
+            propio.tareas[i] = (ResultadoTarea) {
+                .trabajos = tarea->trabajos,
+                .abortados = tarea->abortados,
+                .plazos_perdidos = tarea->datos->plazos_perdidos,
+                .sobrecostes = tarea->datos->sobrecostes,
+                .activaciones_omitidas = tarea->datos->activaciones_omitidas,
+                .consumo_maximo = tarea->consumo_maximo
+            };
+        }
+
+        bool escrito = write(tuberia[1], &propio, sizeof(propio)) == (ssize_t) sizeof(propio);
+        _exit(escrito ? EXIT_SUCCESS : EXIT_FAILURE);
+    }
+
+    close(tuberia[1]);
+    size_t leidos = 0;
+    ssize_t bloque = 1;
+    while (hijo > 0 && leidos < sizeof(*resultado) && bloque > 0)
+    {
+        bloque = read(tuberia[0], (char *) resultado + leidos, sizeof(*resultado) - leidos);
+        if (bloque > 0) leidos += (size_t) bloque;
+    }
+    close(tuberia[0]);
+
+    int estado = 0;
+    if (hijo < 0 || waitpid(hijo, &estado, 0) != hijo) return false;
+
+    return leidos == sizeof(*resultado) && WIFEXITED(estado) && WEXITSTATUS(estado) == EXIT_SUCCESS;
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:         Comprueba que las estadísticas del anti-thrashing
+ *                  reflejan su efecto: si una configuración reduce los
+ *                  cambios de contexto respecto al LLF puro, los cambios
+ *                  evitados no pueden ser cero.
+ *
+ * Autor:           Juan Misael Sánchez Pacheco
+ * Fecha:           17 de octubre de 2026
+ * Versión:         1.0
+ * Observaciones:   Sin anti-thrashing no puede haber cambios evitados ni
+ *                  plazos perdidos por su causa.
+ */
+static bool comprobarAntiThrashing(uint64_t ticks)
+{
+    static const TickType_t casos[CASOS_ANTI_THRASHING][2] = { { 5, 10 }, { 0, 20 }, { 20, 0 }, { 50, 50 }, { 2, 0 } };
+
+    ConfiguracionSimulacion configuracion = { .ticks = ticks, .politica = "LLF", .anti_thrashing = true };
+    ResultadoSimulacion puro, resultado;
+
+    if (!simularEnHijo(&configuracion, &puro))
+    {
+        printf("Anti-thrashing: la simulación sin anti-thrashing no ha terminado\n");
+        return false;
+    }
+
+    bool correcto = puro.estadisticas.cambios_evitados == 0 && puro.estadisticas.perdidas_introducidas == 0;
+    printf("Anti-thrashing 0/0: %u cambios de contexto, %u evitados: %s\n", puro.estadisticas.cambios_contexto,
+        puro.estadisticas.cambios_evitados, correcto ? "correcto" : "FALLO");
+
+    for (int i = 0; i < CASOS_ANTI_THRASHING; i++)
+    {
+        configuracion.histeresis = casos[i][0];
+        configuracion.cuanto = casos[i][1];
+
+        bool caso = simularEnHijo(&configuracion, &resultado);
+        caso = caso && (resultado.estadisticas.cambios_contexto >= puro.estadisticas.cambios_contexto ||
+                        resultado.estadisticas.cambios_evitados > 0);
+
+        printf("Anti-thrashing %lu/%lu: %u cambios de contexto, %u evitados, %u plazos perdidos por su causa: %s\n",
+            (unsigned long) casos[i][0], (unsigned long) casos[i][1], resultado.estadisticas.cambios_contexto,
+            resultado.estadisticas.cambios_evitados, resultado.estadisticas.perdidas_introducidas,
+            caso ? "correcto" : "FALLO");
+        correcto = correcto && caso;
+    }
+
+    return correcto;
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Función:         Comprueba las políticas de sobrecoste sobre T4 con una
+ *                  ejecución inyectada que agota su presupuesto en cada
+ *                  trabajo: sin medida el trabajo consume todo el exceso,
+ *                  al abortar no pasa del presupuesto, al omitir se salta
+ *                  la activación siguiente y al degradar el trabajo
+ *                  termina completo sin abortar ni omitir nada.
+ *
+ * Autor:           Juan Misael Sánchez Pacheco
+ * Fecha:           17 de octubre de 2026
+ * Versión:         1.0
+ * Observaciones:   Sin exceso inyectado, T4 no puede agotar su
+ *                  presupuesto y ninguna política llega a actuar.
+ */
+static bool comprobarSobrecostes(uint64_t ticks)
+{
+    static const PoliticaSobrecoste casos[CASOS_SOBRECOSTE] = {
+        SOBRECOSTE_NINGUNO, SOBRECOSTE_ABORTAR, SOBRECOSTE_OMITIR_SIGUIENTE, SOBRECOSTE_DEGRADAR
+    };
+    static const char *const nombres[CASOS_SOBRECOSTE] = { "NINGUNO", "ABORTAR", "OMITIR_SIGUIENTE", "DEGRADAR" };
+
+    // El presupuesto de T4 (margen 0) se agota en cuanto consume un tick más que
+    // EJECUCION_T4; el controlador lo detecta en la pasada de ese instante.
+    const uint32_t presupuesto = (EJECUCION_T4 + 1) * MICROSEGUNDOS_POR_TICK;
+    const uint32_t completo = (EJECUCION_T4 + EXCESO_COMPROBACION) * MICROSEGUNDOS_POR_TICK;
+
+    ConfiguracionSimulacion configuracion = { .ticks = ticks, .politica = "LLF", .sobrecoste_T4 = SOBRECOSTE_ABORTAR };
+    ResultadoSimulacion resultado;
+
+    // Sin exceso, como en main_base.c por defecto.
+    bool correcto = simularEnHijo(&configuracion, &resultado);
+    const ResultadoTarea *t4 = &resultado.tareas[T4 - modelo];
+    correcto = correcto && t4->sobrecostes == 0 && t4->abortados == 0 && t4->activaciones_omitidas == 0;
+    printf("Sobrecoste ABORTAR sin exceso: %u trabajos de T4, %u sobrecostes, %u abortados: %s\n",
+        t4->trabajos, t4->sobrecostes, t4->abortados, correcto ? "correcto" : "FALLO");
+
+    configuracion.exceso_T4 = EXCESO_COMPROBACION;
+    for (int i = 0; i < CASOS_SOBRECOSTE; i++)
+    {
+        configuracion.sobrecoste_T4 = casos[i];
+
+        bool caso = simularEnHijo(&configuracion, &resultado) && t4->trabajos > 0 && t4->sobrecostes > 0;
+        switch (casos[i])
+        {
+            case SOBRECOSTE_ABORTAR:
+                caso = caso && t4->abortados == t4->sobrecostes && t4->activaciones_omitidas == 0 &&
+                       t4->consumo_maximo <= presupuesto;
+                break;
+
+            case SOBRECOSTE_OMITIR_SIGUIENTE:
+                caso = caso && t4->abortados == 0 && t4->activaciones_omitidas > 0 && t4->consumo_maximo >= completo;
+                break;
+
+            default:
+                caso = caso && t4->abortados == 0 && t4->activaciones_omitidas == 0 && t4->consumo_maximo >= completo;
+                break;
+        }
+
+        printf("Sobrecoste %s con %lu ticks de exceso: %u trabajos de T4, %u sobrecostes, %u abortados, "
+            "%u activaciones omitidas, %u µs de consumo máximo: %s\n", nombres[i], (unsigned long) EXCESO_COMPROBACION,
+            t4->trabajos, t4->sobrecostes, t4->abortados, t4->activaciones_omitidas, t4->consumo_maximo,
+            caso ? "correcto" : "FALLO");
+        correcto = correcto && caso;
+    }
+
+    return correcto;
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Tarea:       Código de las tareas registradas en el controlador.
+ *              El simulador no las ejecuta: su comportamiento lo
+ *              modelan activarTrabajo y completarTramo.
+ *
+ * Autor:       Juan Misael Sánchez Pacheco
+ * Fecha:       17 de octubre de 2026
+ * Versión:     1.0
+ */
+static void xTareaSimulada( void * pvParameters )
+{
+    ( void ) pvParameters;
+}
+
+
+
+
+/*-----------------------------------------------------------*/
+
+
+
+
+/* INTERFAZ DEL KERNEL SIMULADA. */
+
+// Funciones de FreeRTOS que usa planificador.c, implementadas sobre el tiempo
+// simulado. El simulador se enlaza sin el kernel.
+
+void *pvPortMalloc(size_t tamano)
+{
+    return malloc(tamano);
+}
+
+void vPortFree(void *memoria)
+{
+    free(memoria);
+}
+
+BaseType_t xTaskCreate(TaskFunction_t codigo, const char * const nombre, const configSTACK_DEPTH_TYPE pila,
+                       void * const parametros, UBaseType_t prioridad, TaskHandle_t * const handle)
+{
+    ( void ) codigo;
+    ( void ) pila;
+    ( void ) parametros;
+
+    struct tskTaskControlBlock *tcb = calloc(1, sizeof(struct tskTaskControlBlock));
+    if (tcb == NULL) return pdFAIL;
+
+    strncpy(tcb->nombre, nombre, configMAX_TASK_NAME_LEN - 1);
+    tcb->prioridad = prioridad;
+    if (handle != NULL) *handle = tcb;
+
+    // La primera tarea creada es la del controlador (iniciarPlanificadorLLF).
+    if (controlador == NULL) controlador = tcb;
+
+    return pdPASS;
+}
+
+void vTaskDelete(TaskHandle_t handle)
+{
+    free(handle);
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    return handle_en_ejecucion;
+}
+
+void vTaskSuspendAll(void)
+{
+    // Sin concurrencia en el simulador.
+}
+
+BaseType_t xTaskResumeAll(void)
+{
+    return pdFALSE;
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+    return (TickType_t) ahora;
+}
+
+eTaskState eTaskGetState(TaskHandle_t handle)
+{
+    const TareaSimulada *tarea = handle->tarea;
+
+    if (handle == handle_en_ejecucion) return eRunning;
+    if (tarea != NULL && tarea->activa && !tarea->bloqueada) return eReady;
+    return eBlocked;
+}
+
+void vTaskPrioritySet(TaskHandle_t handle, UBaseType_t prioridad)
+{
+    handle->prioridad = prioridad;
+}
+
+void vTaskSetApplicationTaskTag(TaskHandle_t handle, TaskHookFunction_t etiqueta)
+{
+    handle->etiqueta = (void *) etiqueta;
+}
+
+char *pcTaskGetName(TaskHandle_t handle)
+{
+    return handle->nombre;
+}
+
+BaseType_t xTaskGenericNotify(TaskHandle_t handle, UBaseType_t indice, uint32_t valor,
+                              eNotifyAction accion, uint32_t *valor_previo)
+{
+    ( void ) handle;
+    ( void ) indice;
+    ( void ) valor;
+    ( void ) accion;
+    ( void ) valor_previo;
+
+    // Solo se notifica al controlador.
+    pasada_pendiente = true;
+    return pdPASS;
+}
+
+uint32_t ulTaskGenericNotifyTake(UBaseType_t indice, BaseType_t limpiar, TickType_t espera)
+{
+    // La tarea del controlador no se ejecuta en el simulador.
+    ( void ) indice;
+    ( void ) limpiar;
+    ( void ) espera;
+    return 0;
+}
+
+BaseType_t xTaskDelayUntil(TickType_t * const activacion, const TickType_t incremento)
+{
+    ( void ) activacion;
+    ( void ) incremento;
+    return pdFALSE;
+}
+
+unsigned long ulGetRunTimeCounterValue(void)
+{
+    return (unsigned long) (ahora * MICROSEGUNDOS_POR_TICK);
+}